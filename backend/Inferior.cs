@@ -29,6 +29,7 @@ namespace Mono.Debugger.Backend
 		protected readonly DebuggerErrorHandler error_handler;
 		protected readonly BreakpointManager breakpoint_manager;
 		protected readonly AddressDomain address_domain;
+		protected readonly TargetMemoryCache memory_cache;
 		protected readonly bool native;
 
 		int child_pid;
@@ -37,6 +38,7 @@ namespace Mono.Debugger.Backend
 		bool pushed_regs;
 
 		TargetMemoryInfo target_info;
+		TargetMemoryReadHandler read_handler;
 		Architecture arch;
 
 		bool has_signals;
@@ -99,6 +101,9 @@ namespace Mono.Debugger.Backend
 		[DllImport("monodebuggerserver")]
 		static extern TargetError mono_debugger_server_read_memory (IntPtr handle, long start, int size, IntPtr data);
 
+		[DllImport("monodebuggerserver")]
+		static extern TargetError mono_debugger_server_read_string (IntPtr handle, long start, int char_size, int max_length, out int length, out IntPtr data);
+
 		[DllImport("monodebuggerserver")]
 		static extern TargetError mono_debugger_server_write_memory (IntPtr handle, long start, int size, IntPtr data);
 
@@ -127,7 +132,7 @@ namespace Mono.Debugger.Backend
 		static extern TargetError mono_debugger_server_call_method_invoke (IntPtr handle, long invoke_method, long method_address, int num_params, int blob_size, IntPtr param_data, IntPtr offset_data, IntPtr blob_data, long callback_argument, bool debug);
 
 		[DllImport("monodebuggerserver")]
-		static extern TargetError mono_debugger_server_execute_instruction (IntPtr handle, IntPtr instruction, int insn_size, bool update_ip);
+		static extern TargetError mono_debugger_server_execute_instruction (IntPtr handle, IntPtr instruction, int insn_size, bool update_ip, int displacement_offset);
 
 		[DllImport("monodebuggerserver")]
 		static extern TargetError mono_debugger_server_insert_breakpoint (IntPtr handle, long address, out int breakpoint);
@@ -156,6 +161,9 @@ namespace Mono.Debugger.Backend
 		[DllImport("monodebuggerserver")]
 		static extern TargetError mono_debugger_server_stop_and_wait (IntPtr handle, out int status);
 
+		[DllImport("monodebuggerserver")]
+		static extern TargetError mono_debugger_server_stop_and_wait_group (IntPtr[] handles, int count, [Out] int[] statuses, [Out] TargetError[] results);
+
 		[DllImport("monodebuggerserver")]
 		static extern TargetError mono_debugger_server_set_signal (IntPtr handle, int signal, int send_it);
 
@@ -239,7 +247,8 @@ namespace Mono.Debugger.Backend
 			UNKNOWN = 0,
 			LINUX_PTRACE = 1,
 			DARWIN = 2,
-			WINDOWS = 3
+			WINDOWS = 3,
+			LINUX_PTRACE_SEIZE = 4
 		}
 
 		internal enum ServerCapabilities {
@@ -312,7 +321,8 @@ namespace Mono.Debugger.Backend
 		protected Inferior (ThreadManager thread_manager, Process process,
 				    ProcessStart start, BreakpointManager bpm,
 				    DebuggerErrorHandler error_handler,
-				    AddressDomain address_domain)
+				    AddressDomain address_domain,
+				    TargetMemoryCache memory_cache)
 		{
 			this.thread_manager = thread_manager;
 			this.process = process;
@@ -321,6 +331,8 @@ namespace Mono.Debugger.Backend
 			this.error_handler = error_handler;
 			this.breakpoint_manager = bpm;
 			this.address_domain = address_domain;
+			this.memory_cache = memory_cache;
+			this.read_handler = new TargetMemoryReadHandler (read_memory_raw);
 
 			server_handle = mono_debugger_server_create_inferior (breakpoint_manager.Manager);
 			if (server_handle == IntPtr.Zero)
@@ -332,14 +344,14 @@ namespace Mono.Debugger.Backend
 		{
 			return new Inferior (
 				thread_manager, process, start, process.BreakpointManager, null,
-				thread_manager.AddressDomain);
+				thread_manager.AddressDomain, new TargetMemoryCache ());
 		}
 
 		public Inferior CreateThread (int pid, bool do_attach)
 		{
 			Inferior inferior = new Inferior (
 				thread_manager, process, start, breakpoint_manager,
-				error_handler, address_domain);
+				error_handler, address_domain, memory_cache);
 
 			inferior.child_pid = pid;
 
@@ -449,9 +461,13 @@ namespace Mono.Debugger.Backend
 					Marshal.Copy (blob, 0, blob_data, blob.Length);
 				}
 
+				memory_cache.SetRunning (this, true);
 				check_error (mono_debugger_server_call_method_3 (
 					server_handle, method.Address, method_argument,
 					address, blob != null ? blob.Length : 0, blob_data, callback_arg));
+			} catch {
+				memory_cache.SetRunning (this, false);
+				throw;
 			} finally {
 				if (blob_data != IntPtr.Zero)
 					Marshal.FreeHGlobal (blob_data);
@@ -515,10 +531,14 @@ namespace Mono.Debugger.Backend
 				offset_data = Marshal.AllocHGlobal (length * 4);
 				Marshal.Copy (blob_offsets, 0, offset_data, length);
 
+				memory_cache.SetRunning (this, true);
 				check_error (mono_debugger_server_call_method_invoke (
 					server_handle, invoke_method.Address, method_argument.Address,
 					length, blob_size, param_data, offset_data, blob_data,
 					callback_arg, debug));
+			} catch {
+				memory_cache.SetRunning (this, false);
+				throw;
 			} finally {
 				if (blob_data != IntPtr.Zero)
 					Marshal.FreeHGlobal (blob_data);
@@ -528,6 +548,16 @@ namespace Mono.Debugger.Backend
 		}
 
 		public void ExecuteInstruction (byte[] instruction, bool update_ip)
+		{
+			ExecuteInstruction (instruction, update_ip, -1);
+		}
+
+		// <summary>
+		//   Execute `instruction' in the code buffer.  If it has an IP-relative
+		//   memory operand, `displacement_offset' is the offset of its 32-bit
+		//   displacement, which the backend adjusts to the code buffer.
+		// </summary>
+		public void ExecuteInstruction (byte[] instruction, bool update_ip, int displacement_offset)
 		{
 			check_disposed ();
 
@@ -536,8 +566,10 @@ namespace Mono.Debugger.Backend
 				data = Marshal.AllocHGlobal (instruction.Length);
 				Marshal.Copy (instruction, 0, data, instruction.Length);
 
+				memory_cache.Flush ();
 				check_error (mono_debugger_server_execute_instruction (
-					server_handle, data, instruction.Length, update_ip));
+					server_handle, data, instruction.Length, update_ip,
+					displacement_offset));
 			} finally {
 				Marshal.FreeHGlobal (data);
 			}
@@ -557,6 +589,7 @@ namespace Mono.Debugger.Backend
 		public int InsertBreakpoint (TargetAddress address)
 		{
 			int retval;
+			memory_cache.Flush ();
 			check_error (mono_debugger_server_insert_breakpoint (
 				server_handle, address.Address, out retval));
 			return retval;
@@ -566,6 +599,7 @@ namespace Mono.Debugger.Backend
 						     out int index)
 		{
 			int retval;
+			memory_cache.Flush ();
 			TargetError result = mono_debugger_server_insert_hw_breakpoint (
 				server_handle, HardwareBreakpointType.NONE, out index,
 				address.Address, out retval);
@@ -583,6 +617,7 @@ namespace Mono.Debugger.Backend
 
 		public void RemoveBreakpoint (int breakpoint)
 		{
+			memory_cache.Flush ();
 			check_error (mono_debugger_server_remove_breakpoint (
 				server_handle, breakpoint));
 		}
@@ -599,12 +634,14 @@ namespace Mono.Debugger.Backend
 
 		public void EnableBreakpoint (int breakpoint)
 		{
+			memory_cache.Flush ();
 			check_error (mono_debugger_server_enable_breakpoint (
 				server_handle, breakpoint));
 		}
 
 		public void DisableBreakpoint (int breakpoint)
 		{
+			memory_cache.Flush ();
 			check_error (mono_debugger_server_disable_breakpoint (
 				server_handle, breakpoint));
 		}
@@ -910,71 +947,71 @@ namespace Mono.Debugger.Backend
 			}
 		}
 
-		IntPtr read_buffer (TargetAddress address, int size)
+		//
+		// The server reads directly into the pinned managed buffer, so there's no
+		// unmanaged allocation and no extra copy.
+		//
+		TargetError read_memory_raw (long address, byte[] buffer, int offset, int size)
 		{
-			IntPtr data = Marshal.AllocHGlobal (size);
-			TargetError result = mono_debugger_server_read_memory (
-				server_handle, address.Address, size, data);
-			if (result == TargetError.MemoryAccess) {
-				Marshal.FreeHGlobal (data);
+			GCHandle gch = GCHandle.Alloc (buffer, GCHandleType.Pinned);
+			try {
+				IntPtr data = (IntPtr) ((long) gch.AddrOfPinnedObject () + offset);
+				return mono_debugger_server_read_memory (server_handle, address, size, data);
+			} finally {
+				gch.Free ();
+			}
+		}
+
+		//
+		// Per-thread scratch buffer for ReadByte(), ReadInteger() and
+		// ReadLongInteger(), so that scalar reads don't allocate anything.
+		//
+		[ThreadStatic]
+		static byte[] scalar_buffer;
+
+		byte[] read_scalar (TargetAddress address, int size)
+		{
+			check_disposed ();
+			if (scalar_buffer == null)
+				scalar_buffer = new byte [8];
+			read_memory (address, scalar_buffer, size);
+			return scalar_buffer;
+		}
+
+		void read_memory (TargetAddress address, byte[] buffer, int size)
+		{
+			if (memory_cache.Read (read_handler, address.Address, buffer, 0, size))
+				return;
+
+			TargetError result = read_memory_raw (address.Address, buffer, 0, size);
+			if (result == TargetError.MemoryAccess)
 				throw new TargetMemoryException (address, size);
-			} else if (result != TargetError.None) {
-				Marshal.FreeHGlobal (data);
+			else if (result != TargetError.None)
 				throw new TargetException (result);
-			}
-			return data;
 		}
 
 		public override byte[] ReadBuffer (TargetAddress address, int size)
 		{
 			check_disposed ();
-			if (size == 0)
-				return new byte [0];
-			IntPtr data = IntPtr.Zero;
-			try {
-				data = read_buffer (address, size);
-				byte[] retval = new byte [size];
-				Marshal.Copy (data, retval, 0, size);
-				return retval;
-			} finally {
-				Marshal.FreeHGlobal (data);
-			}
+			byte[] retval = new byte [size];
+			if (size > 0)
+				read_memory (address, retval, size);
+			return retval;
 		}
 
 		public override byte ReadByte (TargetAddress address)
 		{
-			check_disposed ();
-			IntPtr data = IntPtr.Zero;
-			try {
-				data = read_buffer (address, 1);
-				return Marshal.ReadByte (data);
-			} finally {
-				Marshal.FreeHGlobal (data);
-			}
+			return read_scalar (address, 1) [0];
 		}
 
 		public override int ReadInteger (TargetAddress address)
 		{
-			check_disposed ();
-			IntPtr data = IntPtr.Zero;
-			try {
-				data = read_buffer (address, 4);
-				return Marshal.ReadInt32 (data);
-			} finally {
-				Marshal.FreeHGlobal (data);
-			}
+			return BitConverter.ToInt32 (read_scalar (address, 4), 0);
 		}
 
 		public override long ReadLongInteger (TargetAddress address)
 		{
-			check_disposed ();
-			IntPtr data = IntPtr.Zero;
-			try {
-				data = read_buffer (address, 8);
-				return Marshal.ReadInt64 (data);
-			} finally {
-				Marshal.FreeHGlobal (data);
-			}
+			return BitConverter.ToInt64 (read_scalar (address, 8), 0);
 		}
 
 		public override TargetAddress ReadAddress (TargetAddress address)
@@ -1002,8 +1039,42 @@ namespace Mono.Debugger.Backend
 		}
 
 		public override string ReadString (TargetAddress address)
+		{
+			return ReadString (address, 0);
+		}
+
+		// <summary>
+		//   Read a NUL-terminated string, but at most `max_length' characters
+		//   (0 means no limit).  The server scans for the terminator, so this
+		//   is a single round-trip for most strings.
+		// </summary>
+		public string ReadString (TargetAddress address, int max_length)
 		{
 			check_disposed ();
+
+			int length;
+			IntPtr data;
+			TargetError result = mono_debugger_server_read_string (
+				server_handle, address.Address, 1, max_length, out length, out data);
+			if (result == TargetError.NotImplemented)
+				return read_string_slow (address, max_length);
+			else if (result == TargetError.MemoryAccess)
+				throw new TargetMemoryException (address);
+			else if (result != TargetError.None)
+				throw new TargetException (result);
+
+			try {
+				char[] retval = new char [length];
+				for (int i = 0; i < length; i++)
+					retval [i] = (char) Marshal.ReadByte (data, i);
+				return new String (retval);
+			} finally {
+				g_free (data);
+			}
+		}
+
+		string read_string_slow (TargetAddress address, int max_length)
+		{
 			StringBuilder sb = new StringBuilder ();
 
 			while (true) {
@@ -1014,6 +1085,8 @@ namespace Mono.Debugger.Backend
 					return sb.ToString ();
 
 				sb.Append ((char) b);
+				if (sb.Length == max_length)
+					return sb.ToString ();
 			}
 		}
 
@@ -1033,16 +1106,13 @@ namespace Mono.Debugger.Backend
 		public override void WriteBuffer (TargetAddress address, byte[] buffer)
 		{
 			check_disposed ();
-			IntPtr data = IntPtr.Zero;
+			GCHandle gch = GCHandle.Alloc (buffer, GCHandleType.Pinned);
 			try {
-				int size = buffer.Length;
-				data = Marshal.AllocHGlobal (size);
-				Marshal.Copy (buffer, 0, data, size);
 				check_error (mono_debugger_server_write_memory (
-					server_handle, address.Address, size, data));
+					server_handle, address.Address, buffer.Length,
+					gch.AddrOfPinnedObject ()));
 			} finally {
-				if (data != IntPtr.Zero)
-					Marshal.FreeHGlobal (data);
+				gch.Free ();
 				OnMemoryChanged ();
 			}
 		}
@@ -1145,6 +1215,9 @@ namespace Mono.Debugger.Backend
 
 		TargetState change_target_state (TargetState new_state, int arg)
 		{
+			memory_cache.SetRunning (
+				this, (new_state == TargetState.Running) || (new_state == TargetState.Busy));
+
 			if (new_state == target_state)
 				return target_state;
 
@@ -1219,6 +1292,43 @@ namespace Mono.Debugger.Backend
 			return true;
 		}
 
+		// <summary>
+		//   Stop all of `inferiors' like Stop(out ChildEvent), but send all of
+		//   them the stop signal before waiting for any of them.  Returns false
+		//   if the backend can't do this.
+		// </summary>
+		public static bool StopAll (Inferior[] inferiors, out bool[] stopped,
+					    out ChildEvent[] new_events)
+		{
+			stopped = new bool [inferiors.Length];
+			new_events = new ChildEvent [inferiors.Length];
+
+			IntPtr[] handles = new IntPtr [inferiors.Length];
+			for (int i = 0; i < inferiors.Length; i++) {
+				inferiors [i].check_disposed ();
+				handles [i] = inferiors [i].server_handle;
+			}
+
+			int[] statuses = new int [inferiors.Length];
+			TargetError[] results = new TargetError [inferiors.Length];
+
+			TargetError error = mono_debugger_server_stop_and_wait_group (
+				handles, handles.Length, statuses, results);
+			if (error != TargetError.None)
+				return false;
+
+			for (int i = 0; i < inferiors.Length; i++) {
+				if (results [i] != TargetError.None)
+					continue;
+
+				stopped [i] = true;
+				if (statuses [i] != 0)
+					new_events [i] = inferiors [i].ProcessEvent (statuses [i]);
+			}
+
+			return true;
+		}
+
 		// <summary>
 		//   Just send the inferior a stop signal, but don't wait for it to stop.
 		//   Returns true if it actually sent the signal and false if the target
@@ -1400,6 +1510,7 @@ namespace Mono.Debugger.Backend
 		public TargetAddress PushRegisters ()
 		{
 			long new_rsp;
+			memory_cache.Flush ();
 			check_error (mono_debugger_server_push_registers (server_handle, out new_rsp));
 			pushed_regs = true;
 			return new TargetAddress (AddressDomain, new_rsp);
@@ -1408,6 +1519,7 @@ namespace Mono.Debugger.Backend
 		public void PopRegisters ()
 		{
 			pushed_regs = false;
+			memory_cache.Flush ();
 			check_error (mono_debugger_server_pop_registers (server_handle));
 		}
 
@@ -1608,6 +1720,7 @@ namespace Mono.Debugger.Backend
 
 		protected virtual void OnMemoryChanged ()
 		{
+			memory_cache.Flush ();
 			// child_event (ChildEventType.CHILD_MEMORY_CHANGED, 0);
 		}
 
@@ -1727,6 +1840,7 @@ namespace Mono.Debugger.Backend
 			ServerType type = mono_debugger_server_get_server_type ();
 			switch (type) {
 			case ServerType.LINUX_PTRACE:
+			case ServerType.LINUX_PTRACE_SEIZE:
 				return new LinuxOperatingSystem (process);
 			case ServerType.DARWIN:
 				return new DarwinOperatingSystem (process);
@@ -1759,6 +1873,7 @@ namespace Mono.Debugger.Backend
 
 				// Release unmanaged resources
 				lock (this) {
+					memory_cache.SetRunning (this, false);
 					if (server_handle != IntPtr.Zero) {
 						mono_debugger_server_finalize (server_handle);
 						server_handle = IntPtr.Zero;
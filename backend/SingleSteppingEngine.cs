@@ -169,9 +169,18 @@ namespace Mono.Debugger.Backend
 			if (inferior == null)
 				return;
 
-			ProcessEvent (inferior.ProcessEvent (status));
+			event_timestamp = Stopwatch.GetTimestamp ();
+			try {
+				ProcessEvent (inferior.ProcessEvent (status));
+			} finally {
+				event_timestamp = 0;
+			}
 		}
 
+		// Stopwatch timestamp when we received the event from the wait thread,
+		// zero for the events we create ourselves.
+		long event_timestamp;
+
 		public bool ProcessEvent (Inferior.ChildEvent cevent)
 		{
 			Report.Debug (DebugFlags.EventLoop, "{0} received event {1}",
@@ -196,6 +205,7 @@ namespace Mono.Debugger.Backend
 				// we can't remove the breakpoint anymore after
 				// the target exited, but we need to clear this id.
 				temp_breakpoint = null;
+				range_breakpoints = null;
 				dead = true;
 			} else {
 				string frame_text = "";
@@ -469,6 +479,33 @@ namespace Mono.Debugger.Backend
 				}
 			}
 
+			// Same for the breakpoints of a range stepping operation: we hit
+			// one of them, so remove all of them and let the operation decide
+			// what to do next - unless there's also a user breakpoint here.
+			if ((message == Inferior.ChildEventType.CHILD_HIT_BREAKPOINT) && is_range_breakpoint (arg)) {
+				remove_range_breakpoints ();
+
+				int idx;
+				bool is_enabled;
+				BreakpointHandle handle = process.BreakpointManager.LookupBreakpoint (
+					inferior.CurrentFrame, out idx, out is_enabled);
+
+				Report.Debug (DebugFlags.SSE,
+					      "{0} hit range breakpoint {1} at {2}: {3} {4} {5}",
+					      this, arg, inferior.CurrentFrame, handle, idx, is_enabled);
+
+				if ((handle == null) || !is_enabled || !handle.Breakpoint.Breaks (thread.ID) ||
+				    handle.Breakpoint.HideFromUser) {
+					message = Inferior.ChildEventType.CHILD_STOPPED;
+					arg = 0;
+					cevent = new Inferior.ChildEvent (Inferior.ChildEventType.CHILD_STOPPED, 0, 0, 0);
+				} else {
+					cevent = new Inferior.ChildEvent (Inferior.ChildEventType.CHILD_HIT_BREAKPOINT, idx, 0, 0);
+					ProcessOperationEvent (cevent);
+					return;
+				}
+			}
+
 			if (message == Inferior.ChildEventType.UNHANDLED_EXCEPTION) {
 				TargetAddress exc = new TargetAddress (manager.AddressDomain, cevent.Data1);
 				TargetAddress ip = new TargetAddress (manager.AddressDomain, cevent.Data2);
@@ -480,9 +517,16 @@ namespace Mono.Debugger.Backend
 				// `step_over_breakpoint' does everything for us and we can just continue
 				// execution.
 				Breakpoint bpt;
-				bool remain_stopped = child_breakpoint (cevent, arg, out bpt);
+				bool traced;
+				bool remain_stopped = child_breakpoint (cevent, arg, out bpt, out traced);
 				if (!remain_stopped) {
 					do_continue ();
+
+					// The tracepoint overhead includes getting the event, the
+					// data collection and stepping over the breakpoint.
+					if (traced && (event_timestamp != 0))
+						process.TraceBuffer.AddOverhead (
+							Stopwatch.GetTimestamp () - event_timestamp);
 					return;
 				}
 			}
@@ -627,6 +671,7 @@ namespace Mono.Debugger.Backend
 		{
 			lock (this) {
 				remove_temporary_breakpoint ();
+				remove_range_breakpoints ();
 				engine_stopped = true;
 				stop_requested = false;
 				last_target_event = args;
@@ -709,6 +754,7 @@ namespace Mono.Debugger.Backend
 			else
 				result = new TargetEventArgs (TargetEventType.TargetExited, arg);
 			temp_breakpoint = null;
+			range_breakpoints = null;
 			dead = true;
 
 			if (current_operation != null)
@@ -1071,9 +1117,14 @@ namespace Mono.Debugger.Backend
 		//
 		//   If we can't find a handler for the breakpoint, the default is to stop
 		//   the target and let the user decide what to do.
+		//
+		//   @traced is true if this was a tracepoint hit which has been collected.
 		// </summary>
-		bool child_breakpoint (Inferior.ChildEvent cevent, int index, out Breakpoint bpt)
+		bool child_breakpoint (Inferior.ChildEvent cevent, int index, out Breakpoint bpt,
+				       out bool traced)
 		{
+			traced = false;
+
 			// The inferior knows about breakpoints from all threads, so if this is
 			// zero, then no other thread has set this breakpoint.
 			if (index == 0) {
@@ -1102,7 +1153,29 @@ namespace Mono.Debugger.Backend
 				return remain_stopped;
 
 			TargetAddress address = inferior.CurrentFrame;
-			return bpt.CheckBreakpointHit (thread, address);
+			if (!bpt.CheckBreakpointHit (thread, address))
+				return false;
+
+			// Evaluate the condition right here, on the engine thread, so
+			// we don't need to bother the clients if it's false.
+			StackFrame frame = null;
+			if (bpt.HasCondition) {
+				frame = compute_frame (address);
+				if (!bpt.CheckCondition (frame))
+					return false;
+			} else
+				bpt.HandleHit ();
+
+			if (!bpt.IsTracepoint)
+				return true;
+
+			// Tracepoints never stop; collect the data and resume.
+			if ((frame == null) && bpt.TraceNeedsFrame)
+				frame = compute_frame (address);
+
+			process.TraceBuffer.Collect (bpt, thread, inferior, address, frame);
+			traced = true;
+			return false;
 		}
 
 		bool step_over_breakpoint (bool singlestep, TargetAddress until)
@@ -1137,8 +1210,24 @@ namespace Mono.Debugger.Backend
 				return true;
 			}
 
+			/*
+			 * Jumps and calls have already been interpreted above; an
+			 * instruction with an IP-relative memory operand can still be
+			 * executed in the code buffer if we adjust its displacement.
+			 * Only fall back to stopping all other threads and stepping
+			 * over the removed breakpoint if we can't do that, or if we
+			 * couldn't fully decode the instruction (VEX and friends), so
+			 * we don't know where its displacement is.
+			 */
 			if (instruction.IsIpRelative) {
-				PushOperation (new OperationStepOverBreakpoint (this, index, until));
+				int offset = instruction.IpRelativeDisplacementOffset;
+				if ((offset < 0) || !can_relocate_instruction (instruction, offset)) {
+					PushOperation (new OperationStepOverBreakpoint (this, index, until));
+					return true;
+				}
+
+				PushOperation (new OperationExecuteInstruction (
+					this, instruction.Code, offset, true));
 				return true;
 			}
 
@@ -1146,6 +1235,15 @@ namespace Mono.Debugger.Backend
 			return true;
 		}
 
+		bool can_relocate_instruction (Instruction instruction, int offset)
+		{
+			if (process.MonoManager == null)
+				return false;
+
+			int displacement = BitConverter.ToInt32 (instruction.Code, offset);
+			return process.MonoManager.CodeBufferCanReach (instruction.Address, displacement);
+		}
+
 		void enable_extended_notification (NotificationType type)
 		{
 			long notifications = inferior.ReadLongInteger (extended_notifications_addr);
@@ -1446,6 +1544,70 @@ namespace Mono.Debugger.Backend
 			}
 		}
 
+		List<TemporaryBreakpointData> range_breakpoints = null;
+
+		// <summary>
+		//   Insert the breakpoints for a range stepping operation, see
+		//   OperationStep.RangeStep().  Unlike the temporary breakpoint, these
+		//   are always software breakpoints since we usually need more of them
+		//   than there are debug registers.
+		// </summary>
+		bool insert_range_breakpoints (TargetAddress[] addresses)
+		{
+			check_inferior ();
+
+			if (range_breakpoints != null)
+				throw new InternalError ("range_breakpoints != null");
+
+			TargetAddress current = inferior.CurrentFrame;
+
+			range_breakpoints = new List<TemporaryBreakpointData> ();
+			try {
+				foreach (TargetAddress address in addresses) {
+					if (address == current)
+						continue;
+
+					int id = inferior.InsertBreakpoint (address);
+					range_breakpoints.Add (new TemporaryBreakpointData (id, address));
+				}
+			} catch (TargetException ex) {
+				Report.Debug (DebugFlags.SSE, "{0} cannot insert range breakpoints: {1}",
+					      this, ex.Message);
+				remove_range_breakpoints ();
+				return false;
+			}
+
+			Report.Debug (DebugFlags.SSE, "{0} inserted {1} range breakpoints",
+				      this, range_breakpoints.Count);
+			return true;
+		}
+
+		void remove_range_breakpoints ()
+		{
+			if (range_breakpoints == null)
+				return;
+
+			Report.Debug (DebugFlags.SSE, "{0} removing {1} range breakpoints",
+				      this, range_breakpoints.Count);
+
+			foreach (TemporaryBreakpointData breakpoint in range_breakpoints)
+				inferior.RemoveBreakpoint (breakpoint.ID);
+			range_breakpoints = null;
+		}
+
+		bool is_range_breakpoint (int id)
+		{
+			if (range_breakpoints == null)
+				return false;
+
+			foreach (TemporaryBreakpointData breakpoint in range_breakpoints) {
+				if (breakpoint.ID == id)
+					return true;
+			}
+
+			return false;
+		}
+
 		// <summary>
 		//   Step over the next machine instruction.
 		// </summary>
@@ -1683,6 +1845,15 @@ namespace Mono.Debugger.Backend
 
 			Inferior.ChildEvent stop_event;
 			bool stopped = inferior.Stop (out stop_event);
+			AcquireThreadLock (stopped, stop_event);
+		}
+
+		// <summary>
+		//   The second half of AcquireThreadLock(), after the caller already
+		//   stopped the target; see StopEngines().
+		// </summary>
+		internal void AcquireThreadLock (bool stopped, Inferior.ChildEvent stop_event)
+		{
 			thread_lock = new ThreadLockData (stopped, stop_event, true);
 
 			Report.Debug (DebugFlags.Threads,
@@ -1754,6 +1925,40 @@ namespace Mono.Debugger.Backend
 			ProcessEvent (cevent);
 		}
 
+		// <summary>
+		//   Stop all the `engines' at once: the backend first signals every
+		//   thread and then collects all the stop events in one wait loop, so
+		//   this doesn't take one full round-trip per thread.
+		//
+		//   Call SuspendUserThread(bool,ChildEvent) or
+		//   AcquireThreadLock(bool,ChildEvent) on each engine afterwards.
+		// </summary>
+		internal static void StopEngines (SingleSteppingEngine[] engines, out bool[] stopped,
+						  out Inferior.ChildEvent[] stop_events)
+		{
+			if (!ThreadManager.InBackgroundThread)
+				throw new InternalError ();
+
+			Inferior[] inferiors = new Inferior [engines.Length];
+			for (int i = 0; i < engines.Length; i++) {
+				if (engines [i].HasThreadLock)
+					throw new InternalError ("Recursive thread lock");
+				inferiors [i] = engines [i].inferior;
+			}
+
+			Stopwatch watch = Stopwatch.StartNew ();
+
+			if (!Inferior.StopAll (inferiors, out stopped, out stop_events)) {
+				// Not supported by this backend.
+				for (int i = 0; i < engines.Length; i++)
+					stopped [i] = inferiors [i].Stop (out stop_events [i]);
+			}
+
+			watch.Stop ();
+			Report.Debug (DebugFlags.Threads, "Stopped {0} threads in {1} ms",
+				      engines.Length, watch.ElapsedMilliseconds);
+		}
+
 		internal override void SuspendUserThread ()
 		{
 			if (!ThreadManager.InBackgroundThread)
@@ -1770,7 +1975,15 @@ namespace Mono.Debugger.Backend
 
 			Inferior.ChildEvent stop_event;
 			bool stopped = inferior.Stop (out stop_event);
+			SuspendUserThread (stopped, stop_event);
+		}
 
+		// <summary>
+		//   The second half of SuspendUserThread(), after the caller already
+		//   stopped the target; see StopEngines().
+		// </summary>
+		internal void SuspendUserThread (bool stopped, Inferior.ChildEvent stop_event)
+		{
 			stop_requested = true;
 
 			if (stop_event != null) {
@@ -3324,14 +3537,21 @@ namespace Mono.Debugger.Backend
 	{
 		public readonly byte[] Instruction;
 		public readonly bool UpdateIP;
+		public readonly int DisplacementOffset;
 
 		bool pushed_code_buffer;
 
 		public OperationExecuteInstruction (SingleSteppingEngine sse, byte[] insn,
 						    bool update_ip)
+			: this (sse, insn, -1, update_ip)
+		{ }
+
+		public OperationExecuteInstruction (SingleSteppingEngine sse, byte[] insn,
+						    int displacement_offset, bool update_ip)
 			: base (sse, null)
 		{
 			this.Instruction = insn;
+			this.DisplacementOffset = displacement_offset;
 			this.UpdateIP = update_ip;
 		}
 
@@ -3351,7 +3571,7 @@ namespace Mono.Debugger.Backend
 				return;
 			}
 
-			inferior.ExecuteInstruction (Instruction, UpdateIP);
+			inferior.ExecuteInstruction (Instruction, UpdateIP, DisplacementOffset);
 		}
 
 		protected override EventResult DoProcessEvent (Inferior.ChildEvent cevent,
@@ -3365,7 +3585,7 @@ namespace Mono.Debugger.Backend
 			args = null;
 			if (pushed_code_buffer) {
 				pushed_code_buffer = false;
-				inferior.ExecuteInstruction (Instruction, UpdateIP);
+				inferior.ExecuteInstruction (Instruction, UpdateIP, DisplacementOffset);
 				return EventResult.Running;
 			}
 
@@ -3590,10 +3810,179 @@ namespace Mono.Debugger.Backend
 			return false;
 		}
 
+		const int MaxRangeSize = 4096;
+		const int MaxRangeBreakpoints = 32;
+
+		StepFrame range_frame;
+		RangeStepData range_data;
+
+		protected sealed class RangeStepData
+		{
+			// The start addresses of all instructions in the range, sorted.
+			public readonly long[] Instructions;
+			public readonly TargetAddress[] Stops;
+
+			public RangeStepData (long[] instructions, TargetAddress[] stops)
+			{
+				this.Instructions = instructions;
+				this.Stops = stops;
+			}
+		}
+
+		// <summary>
+		//   Instead of single-stepping every instruction of the current source
+		//   line, disassemble the line once, insert breakpoints on every
+		//   instruction which may take us out of it and resume the target.
+		//
+		//   Those are the targets of all jumps leaving the line, the address
+		//   behind it, the return site of all calls we step over and the call,
+		//   indirect jump and return instructions which Step() needs to look at
+		//   before they're executed.  Hitting one of these breakpoints brings
+		//   us back to Step(), just like a single-step would.
+		//
+		//   Returns false if we can't do this and need to single-step.
+		// </summary>
+		protected bool RangeStep (Instruction instruction)
+		{
+			if ((StepMode != StepMode.SourceLine) && (StepMode != StepMode.NextLine))
+				return false;
+
+			if ((instruction == null) || !instruction.HasInstructionSize ||
+			    (instruction.InstructionType == Instruction.Type.IndirectJump) ||
+			    (instruction.InstructionType == Instruction.Type.Ret))
+				return false;
+
+			if (range_frame != StepFrame) {
+				range_frame = StepFrame;
+				range_data = compute_range_stops (StepFrame);
+			}
+
+			if (range_data == null)
+				return false;
+
+			// We're not at the start of an instruction as we decoded them.
+			if (Array.BinarySearch (range_data.Instructions, instruction.Address.Address) < 0)
+				return false;
+
+			if (!sse.insert_range_breakpoints (range_data.Stops))
+				return false;
+
+			Report.Debug (DebugFlags.SSE, "{0} range stepping at {1} in {2}",
+				      sse, inferior.CurrentFrame, StepFrame);
+
+			sse.do_continue ();
+			return true;
+		}
+
+		RangeStepData compute_range_stops (StepFrame frame)
+		{
+			TargetAddress start = frame.Start;
+			TargetAddress end = frame.End;
+
+			if (start.IsNull || end.IsNull || (end <= start) || (end - start > MaxRangeSize))
+				return null;
+
+			Method method = sse.current_method;
+			bool has_bounds = (method != null) && method.HasMethodBounds;
+			bool step_over_calls = StepMode == StepMode.NextLine;
+
+			List<long> instructions = new List<long> ();
+			List<TargetAddress> stops = new List<TargetAddress> ();
+			List<TargetAddress> targets = new List<TargetAddress> ();
+
+			TargetAddress address = start;
+			bool falls_through = true;
+
+			while (address < end) {
+				Instruction insn = inferior.Architecture.ReadInstruction (inferior, address);
+				if ((insn == null) || !insn.HasInstructionSize)
+					return null;
+
+				TargetAddress next = address + insn.InstructionSize;
+				instructions.Add (address.Address);
+				falls_through = true;
+
+				switch (insn.InstructionType) {
+				case Instruction.Type.ConditionalJump:
+				case Instruction.Type.Jump: {
+					TargetAddress target = insn.GetEffectiveAddress (inferior);
+					if (target.IsNull)
+						return null;
+
+					if ((target >= start) && (target < end))
+						targets.Add (target);
+					else
+						stops.Add (target);
+
+					falls_through = insn.InstructionType == Instruction.Type.ConditionalJump;
+					break;
+				}
+
+				case Instruction.Type.Call: {
+					/*
+					 * Step() steps into intra-method calls and decides whether to
+					 * step into any other call in StepMode.SourceLine.
+					 */
+					TargetAddress target = insn.GetEffectiveAddress (inferior);
+					bool intra_method = has_bounds && !target.IsNull &&
+						(target >= method.MethodStartAddress) &&
+						(target < method.MethodEndAddress);
+
+					if (step_over_calls && !intra_method)
+						stops.Add (next);
+					else
+						stops.Add (address);
+					break;
+				}
+
+				case Instruction.Type.IndirectCall:
+					stops.Add (step_over_calls ? next : address);
+					break;
+
+				case Instruction.Type.IndirectJump:
+				case Instruction.Type.Ret:
+					stops.Add (address);
+					falls_through = false;
+					break;
+				}
+
+				address = next;
+			}
+
+			if (falls_through)
+				stops.Add (address);
+
+			// Make sure all the jumps inside the range hit one of our instructions.
+			foreach (TargetAddress target in targets) {
+				if (instructions.BinarySearch (target.Address) < 0)
+					return null;
+			}
+
+			List<TargetAddress> unique = new List<TargetAddress> ();
+			foreach (TargetAddress stop in stops) {
+				if (!unique.Contains (stop))
+					unique.Add (stop);
+			}
+
+			if (unique.Count > MaxRangeBreakpoints)
+				return null;
+
+			Report.Debug (DebugFlags.SSE, "{0} range {1}: {2} instructions, {3} breakpoints",
+				      sse, frame, instructions.Count, unique.Count);
+
+			return new RangeStepData (instructions.ToArray (), unique.ToArray ());
+		}
+
 		protected bool Step (bool first)
 		{
 			TargetAddress current_frame = inferior.CurrentFrame;
 
+			// If we're range stepping, we either hit one of the breakpoints or
+			// stopped for some other reason; the next RangeStep() inserts them
+			// again if necessary.  We may also be sitting on one of them when
+			// we're called from ResumeOperation(), so we can't just continue.
+			sse.remove_range_breakpoints ();
+
 			if (StepMode == StepMode.Run) {
 				TargetAddress until = StepFrame != null ? StepFrame.Until : TargetAddress.Null;
 				if (!until.IsNull && (current_frame == until))
@@ -3645,7 +4034,8 @@ namespace Mono.Debugger.Backend
 			Instruction instruction = inferior.Architecture.ReadInstruction (
 				inferior, current_frame);
 			if ((instruction == null) || !instruction.IsCall) {
-				sse.do_step ();
+				if (!in_frame || !RangeStep (instruction))
+					sse.do_step ();
 				return false;
 			}
 
@@ -4790,6 +5180,7 @@ namespace Mono.Debugger.Backend
 			}
 
 			sse.remove_temporary_breakpoint ();
+			sse.remove_range_breakpoints ();
 			sse.do_continue (ip);
 		}
 
@@ -0,0 +1,162 @@
+using System;
+using System.Collections.Generic;
+
+namespace Mono.Debugger.Backend
+{
+	// <summary>
+	//   An index of address ranges which answers "which range contains this
+	//   address" in O(log n).
+	//
+	//   New ranges are collected in a pending list and merged into the sorted
+	//   array on the next lookup, so adding a large batch of ranges (like all
+	//   the methods we find in one MonoLanguageBackend.Update()) only sorts once.
+	//   Ranges may overlap; in this case, the one with the highest start address
+	//   wins.
+	// </summary>
+	internal sealed class SymbolRangeIndex<T>
+		where T : class
+	{
+		struct Entry
+		{
+			public readonly long Start;
+			public readonly long End;
+			public readonly T Item;
+
+			public Entry (long start, long end, T item)
+			{
+				this.Start = start;
+				this.End = end;
+				this.Item = item;
+			}
+		}
+
+		class EntryComparer : IComparer<Entry>
+		{
+			public int Compare (Entry a, Entry b)
+			{
+				return a.Start.CompareTo (b.Start);
+			}
+		}
+
+		static readonly EntryComparer comparer = new EntryComparer ();
+
+		Entry[] entries = new Entry [0];
+		// max_end [i] is the highest end address of entries [0] ... entries [i].
+		long[] max_end = new long [0];
+		List<Entry> pending = new List<Entry> ();
+
+		public int Count {
+			get {
+				lock (this) {
+					return entries.Length + pending.Count;
+				}
+			}
+		}
+
+		public void Add (TargetAddress start, TargetAddress end, T item)
+		{
+			if (end <= start)
+				return;
+
+			lock (this) {
+				pending.Add (new Entry (start.Address, end.Address, item));
+			}
+		}
+
+		public int RemoveAll (Predicate<T> match)
+		{
+			lock (this) {
+				merge ();
+
+				List<Entry> keep = new List<Entry> (entries.Length);
+				foreach (Entry entry in entries) {
+					if (!match (entry.Item))
+						keep.Add (entry);
+				}
+
+				int removed = entries.Length - keep.Count;
+				if (removed > 0)
+					set_entries (keep.ToArray ());
+				return removed;
+			}
+		}
+
+		public void Clear ()
+		{
+			lock (this) {
+				pending.Clear ();
+				set_entries (new Entry [0]);
+			}
+		}
+
+		public T Lookup (TargetAddress address)
+		{
+			long addr = address.Address;
+
+			lock (this) {
+				merge ();
+
+				// Find the first entry which starts above `addr'.
+				int lo = 0, hi = entries.Length;
+				while (lo < hi) {
+					int mid = (lo + hi) / 2;
+					if (entries [mid].Start <= addr)
+						lo = mid + 1;
+					else
+						hi = mid;
+				}
+
+				for (int i = lo - 1; (i >= 0) && (max_end [i] > addr); i--) {
+					if (addr < entries [i].End)
+						return entries [i].Item;
+				}
+
+				return null;
+			}
+		}
+
+		void merge ()
+		{
+			if (pending.Count == 0)
+				return;
+
+			Entry[] added = pending.ToArray ();
+			pending.Clear ();
+			Array.Sort (added, comparer);
+
+			Entry[] merged = new Entry [entries.Length + added.Length];
+			int i = 0, j = 0, k = 0;
+			while ((i < entries.Length) && (j < added.Length)) {
+				if (added [j].Start < entries [i].Start)
+					merged [k++] = added [j++];
+				else
+					merged [k++] = entries [i++];
+			}
+			while (i < entries.Length)
+				merged [k++] = entries [i++];
+			while (j < added.Length)
+				merged [k++] = added [j++];
+
+			set_entries (merged);
+		}
+
+		void set_entries (Entry[] new_entries)
+		{
+			long[] new_max_end = new long [new_entries.Length];
+			long max = Int64.MinValue;
+			for (int i = 0; i < new_entries.Length; i++) {
+				max = Math.Max (max, new_entries [i].End);
+				new_max_end [i] = max;
+			}
+
+			entries = new_entries;
+			max_end = new_max_end;
+		}
+
+		public override string ToString ()
+		{
+			return String.Format ("SymbolRangeIndex ({0}:{1})", entries.Length,
+					      pending.Count);
+		}
+	}
+}
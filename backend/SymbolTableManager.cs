@@ -1,5 +1,6 @@
 using System;
 using System.Collections;
+using System.Collections.Generic;
 using ST = System.Threading;
 using System.Runtime.InteropServices;
 
@@ -9,27 +10,94 @@ namespace Mono.Debugger.Backend
 {
 	// <summary>
 	//   This class maintains the debugger's symbol tables.
+	//
+	//   Address lookups go through two process-wide range indices: one over
+	//   the address ranges of native modules and one over the code ranges of
+	//   all JIT-compiled methods.  Only symbol files which don't have any address
+	//   range information are still searched linearly.
 	// </summary>
 	internal class SymbolTableManager : DebuggerMarshalByRefObject, ISymbolTable, IDisposable
 	{
 		ArrayList symbol_files;
+		SymbolRangeIndex<SymbolFile> module_index;
+		SymbolRangeIndex<MethodRange> method_index;
 
 		internal SymbolTableManager (DebuggerSession session)
 		{
 			this.symbol_files = ArrayList.Synchronized (new ArrayList ());
+			this.module_index = new SymbolRangeIndex<SymbolFile> ();
+			this.method_index = new SymbolRangeIndex<MethodRange> ();
 		}
 
+		// <summary>
+		//   Add a symbol file which doesn't provide any address ranges; it's
+		//   searched linearly.
+		// </summary>
 		internal void AddSymbolFile (SymbolFile symfile)
 		{
 			symbol_files.Add (symfile);
 		}
 
+		// <summary>
+		//   Add a symbol file which covers the continuous address range from
+		//   `start' to `end'.
+		// </summary>
+		internal void AddSymbolFile (SymbolFile symfile, TargetAddress start, TargetAddress end)
+		{
+			module_index.Add (start, end, symfile);
+		}
+
+		// <summary>
+		//   Add the code range of a JIT-compiled method.
+		// </summary>
+		internal void AddMethodRange (SymbolFile symfile, int domain, SymbolRangeEntry range)
+		{
+			method_index.Add (range.StartAddress, range.EndAddress,
+					  new MethodRange (symfile, domain, range));
+		}
+
+		internal void RemoveSymbolFile (SymbolFile symfile)
+		{
+			symbol_files.Remove (symfile);
+			module_index.RemoveAll (delegate (SymbolFile file) {
+				return file == symfile;
+			});
+			method_index.RemoveAll (delegate (MethodRange method) {
+				return method.SymbolFile == symfile;
+			});
+		}
+
+		// <summary>
+		//   The code of all methods which were compiled in `domain' is freed
+		//   when the domain is unloaded.
+		// </summary>
+		internal void RemoveDomain (int domain)
+		{
+			method_index.RemoveAll (delegate (MethodRange method) {
+				return method.Domain == domain;
+			});
+		}
+
 		//
 		// ISymbolLookup
 		//
 
 		public Method Lookup (TargetAddress address)
 		{
+			MethodRange range = method_index.Lookup (address);
+			if (range != null) {
+				Method method = range.Range.SymbolLookup.Lookup (address);
+				if (method != null)
+					return method;
+			}
+
+			SymbolFile module = module_index.Lookup (address);
+			if ((module != null) && module.SymbolsLoaded) {
+				Method method = module.SymbolTable.Lookup (address);
+				if (method != null)
+					return method;
+			}
+
 			foreach (SymbolFile symfile in symbol_files) {
 				if (!symfile.SymbolsLoaded)
 					continue;
@@ -44,6 +112,20 @@ namespace Mono.Debugger.Backend
 
 		public Symbol SimpleLookup (TargetAddress address, bool exact_match)
 		{
+			MethodRange range = method_index.Lookup (address);
+			if (range != null) {
+				Symbol name = range.SimpleLookup (address, exact_match);
+				if (name != null)
+					return name;
+			}
+
+			SymbolFile module = module_index.Lookup (address);
+			if (module != null) {
+				Symbol name = module.SimpleLookup (address, exact_match);
+				if (name != null)
+					return name;
+			}
+
 			foreach (SymbolFile symfile in symbol_files) {
 				Symbol name = symfile.SimpleLookup (address, exact_match);
 				if (name != null)
@@ -53,6 +135,33 @@ namespace Mono.Debugger.Backend
 			return null;
 		}
 
+		protected class MethodRange
+		{
+			public readonly SymbolFile SymbolFile;
+			public readonly int Domain;
+			public readonly SymbolRangeEntry Range;
+
+			public MethodRange (SymbolFile symfile, int domain, SymbolRangeEntry range)
+			{
+				this.SymbolFile = symfile;
+				this.Domain = domain;
+				this.Range = range;
+			}
+
+			public Symbol SimpleLookup (TargetAddress address, bool exact_match)
+			{
+				Method method = Range.SymbolLookup as Method;
+				if (method == null)
+					return null;
+
+				long offset = address - Range.StartAddress;
+				if (exact_match && (offset != 0))
+					return null;
+
+				return new Symbol (method.Name, Range.StartAddress, (int) offset);
+			}
+		}
+
 		//
 		// ISymbolContainer
 		//
@@ -115,6 +224,8 @@ namespace Mono.Debugger.Backend
 			if (!this.disposed) {
 				if (disposing) {
 					symbol_files = ArrayList.Synchronized (new ArrayList ());
+					module_index.Clear ();
+					method_index.Clear ();
 				}
 				
 				this.disposed = true;
@@ -0,0 +1,163 @@
+using System;
+using System.Collections.Generic;
+
+namespace Mono.Debugger.Backend
+{
+	internal delegate TargetError TargetMemoryReadHandler (long address, byte[] buffer,
+							       int offset, int size);
+
+	// <summary>
+	//   Page-granular cache for reads from the target's address space.
+	//
+	//   There is exactly one cache per address space; it is shared between all
+	//   the Inferiors of a process (see Inferior.CreateThread()) since all
+	//   threads see the same memory.
+	//
+	//   The cache is only valid while all threads which are sharing it are
+	//   stopped - as soon as one of them is resumed or anyone writes to the
+	//   target's memory, it is flushed.  The server already removes inserted
+	//   breakpoints from everything we read, so cached pages always contain the
+	//   original instructions.
+	// </summary>
+	internal sealed class TargetMemoryCache
+	{
+		public const int PageSize = 4096;
+
+		// Number of pages we read at once when filling the cache.
+		public const int FillPages = 4;
+
+		// Reads larger than this bypass the cache.
+		public const int MaxCachedRead = 16 * PageSize;
+
+		const long PageMask = ~((long) PageSize - 1);
+
+		Dictionary<long,byte[]> pages = new Dictionary<long,byte[]> ();
+		Dictionary<Inferior,bool> running = new Dictionary<Inferior,bool> ();
+		int hits, misses, flushes;
+
+		public int Hits {
+			get { return hits; }
+		}
+
+		public int Misses {
+			get { return misses; }
+		}
+
+		public int Flushes {
+			get { return flushes; }
+		}
+
+		public bool IsValid {
+			get {
+				lock (this) {
+					return running.Count == 0;
+				}
+			}
+		}
+
+		public void Flush ()
+		{
+			lock (this) {
+				if (pages.Count > 0)
+					flushes++;
+				pages.Clear ();
+			}
+		}
+
+		public void SetRunning (Inferior inferior, bool is_running)
+		{
+			lock (this) {
+				if (is_running) {
+					running [inferior] = true;
+					if (pages.Count > 0)
+						flushes++;
+					pages.Clear ();
+				} else {
+					running.Remove (inferior);
+				}
+			}
+		}
+
+		// <summary>
+		//   Read `size' bytes at `address' into `buffer', using the cache if possible.
+		//   Returns false if the read must be done without the cache; the caller then
+		//   reads directly from the target and reports the error, if any.
+		// </summary>
+		public bool Read (TargetMemoryReadHandler reader, long address, byte[] buffer,
+				  int offset, int size)
+		{
+			if ((size <= 0) || (size > MaxCachedRead))
+				return false;
+
+			lock (this) {
+				if (running.Count > 0)
+					return false;
+
+				long end = address + size;
+				long page_start = address & PageMask;
+
+				while (page_start < end) {
+					byte[] page;
+					if (pages.TryGetValue (page_start, out page))
+						hits++;
+					else {
+						misses++;
+						page = fill (reader, page_start);
+						if (page == null)
+							return false;
+					}
+
+					long copy_start = Math.Max (address, page_start);
+					long copy_end = Math.Min (end, page_start + PageSize);
+
+					Buffer.BlockCopy (page, (int) (copy_start - page_start), buffer,
+							  offset + (int) (copy_start - address),
+							  (int) (copy_end - copy_start));
+
+					page_start += PageSize;
+				}
+
+				return true;
+			}
+		}
+
+		byte[] fill (TargetMemoryReadHandler reader, long page_address)
+		{
+			//
+			// Try to read the whole aligned window around the requested page
+			// with one single call; if that fails (for instance because one of
+			// the other pages is not mapped), just read the requested one.
+			//
+
+			long window_size = FillPages * PageSize;
+			long window_start = page_address & ~(window_size - 1);
+
+			byte[] window = new byte [window_size];
+			if (reader (window_start, window, 0, (int) window_size) == TargetError.None) {
+				byte[] retval = null;
+				for (int i = 0; i < FillPages; i++) {
+					long addr = window_start + i * PageSize;
+					byte[] page = new byte [PageSize];
+					Buffer.BlockCopy (window, i * PageSize, page, 0, PageSize);
+					pages [addr] = page;
+					if (addr == page_address)
+						retval = page;
+				}
+				return retval;
+			}
+
+			byte[] single = new byte [PageSize];
+			if (reader (page_address, single, 0, PageSize) != TargetError.None)
+				return null;
+
+			pages [page_address] = single;
+			return single;
+		}
+
+		public override string ToString ()
+		{
+			return String.Format ("TargetMemoryCache ({0}:{1}:{2}:{3})", pages.Count,
+					      hits, misses, flushes);
+		}
+	}
+}
@@ -21,6 +21,12 @@ namespace Mono.Debugger.Backend
 	{
 		public static TimeSpan WaitTimeout = TimeSpan.FromMilliseconds (5000);
 
+		// <summary>
+		//   How many events the engine thread processes in one wakeup before
+		//   it looks at the user's commands again.
+		// </summary>
+		const int MaxEventsPerWakeup = 256;
+
 		internal ThreadManager (Debugger debugger)
 		{
 			this.debugger = debugger;
@@ -82,6 +88,9 @@ namespace Mono.Debugger.Backend
 		[DllImport("monodebuggerserver")]
 		static extern int mono_debugger_server_global_wait (out int status);
 
+		[DllImport("monodebuggerserver")]
+		static extern int mono_debugger_server_global_wait_nohang (out int status);
+
 		[DllImport("monodebuggerserver")]
 		static extern Inferior.ChildEventType mono_debugger_server_dispatch_simple (int status, out int arg);
 
@@ -325,23 +334,37 @@ namespace Mono.Debugger.Backend
 			current_command = null;
 
 			if (event_engine != null) {
-				try {
-					Report.Debug (DebugFlags.Wait,
-						      "ThreadManager {0} process event: {1}",
-						      DebuggerWaitHandle.CurrentThread, event_engine);
-					event_engine.ProcessEvent (status);
-					Report.Debug (DebugFlags.Wait,
-						      "ThreadManager {0} process event done: {1}",
-						      DebuggerWaitHandle.CurrentThread, event_engine);
-				} catch (ST.ThreadAbortException) {
-					;
-				} catch (Exception e) {
+				process_event (event_engine, status);
+				check_pending_events ();
+
+				//
+				// When many threads stop at the same time, the server already
+				// collected their events while waiting for this one; process
+				// all of them here instead of doing the whole round-trip through
+				// the wait thread for each of them.
+				//
+
+				int count = 1;
+				while (!abort_requested && (count < MaxEventsPerWakeup)) {
+					int pid = mono_debugger_server_global_wait_nohang (out status);
+					if (pid <= 0)
+						break;
+
 					Report.Debug (DebugFlags.Wait,
-						      "ThreadManager caught exception: {0}", e);
-					Console.WriteLine ("EXCEPTION: {0}", e);
+						      "ThreadManager received queued event: {0} {1:x}",
+						      pid, status);
+
+					event_engine = get_event_engine (pid, status);
+					if (event_engine == null)
+						continue;
+
+					process_event (event_engine, status);
+					check_pending_events ();
+					count++;
 				}
 
-				check_pending_events ();
+				Report.Debug (DebugFlags.Wait, "ThreadManager processed {0} events",
+					      count);
 
 				if (command == null)
 					engine_event.Set ();
@@ -390,6 +413,25 @@ namespace Mono.Debugger.Backend
 			}
 		}
 
+		void process_event (SingleSteppingEngine engine, int status)
+		{
+			try {
+				Report.Debug (DebugFlags.Wait,
+					      "ThreadManager {0} process event: {1}",
+					      DebuggerWaitHandle.CurrentThread, engine);
+				engine.ProcessEvent (status);
+				Report.Debug (DebugFlags.Wait,
+					      "ThreadManager {0} process event done: {1}",
+					      DebuggerWaitHandle.CurrentThread, engine);
+			} catch (ST.ThreadAbortException) {
+				;
+			} catch (Exception e) {
+				Report.Debug (DebugFlags.Wait,
+					      "ThreadManager caught exception: {0}", e);
+				Console.WriteLine ("EXCEPTION: {0}", e);
+			}
+		}
+
 		void check_pending_events ()
 		{
 			SingleSteppingEngine[] list = new SingleSteppingEngine [pending_events.Count];
@@ -561,45 +603,9 @@ namespace Mono.Debugger.Backend
 				}
 			}
 
-			SingleSteppingEngine event_engine = (SingleSteppingEngine) thread_hash [pid];
-			if (event_engine == null && Inferior.HasThreadEvents) {
-				int arg;
-				Inferior.ChildEventType etype = mono_debugger_server_dispatch_simple (status, out arg);
-
-				/*
-				 * Ignore exit events from unknown children.
-				 */
-
-				if ((etype == Inferior.ChildEventType.CHILD_EXITED) && (arg == 0))
-					goto again;
-
-				/*
-				 * There is a race condition in the Linux kernel which shows up on >= 2.6.27:
-				 *
-				 * When creating a new thread, the initial stopping event of that thread is sometimes
-				 * sent before sending the `PTRACE_EVENT_CLONE' for it.
-				 *
-				 * Because of this, we explicitly wait for the new thread to stop and ignore any
-				 * "early" stopping signals.
-				 *
-				 * See also the comments in _server_ptrace_wait_for_new_thread() in x86-linux-ptrace.c
-				 * and bugs #423518 and #466012.
-				 *
-				 */
-
-				if ((etype != Inferior.ChildEventType.CHILD_STOPPED) || (arg != 0)) {
-					Report.Error ("WARNING: Got event {0:x} for unknown pid {1}", status, pid);
-					waiting = false;
-					RequestWait ();
-					return true;
-				}
-
-				if (!pending_sigstops.ContainsKey (pid))
-					pending_sigstops.Add (pid, DateTime.Now);
-
-				Report.Debug (DebugFlags.Wait, "Ignoring SIGSTOP from unknown pid {0}.", pid);
+			SingleSteppingEngine event_engine = get_event_engine (pid, status);
+			if (event_engine == null)
 				goto again;
-			}
 
 			engine_event.WaitOne ();
 
@@ -621,6 +627,52 @@ namespace Mono.Debugger.Backend
 			return true;
 		}
 
+		// <summary>
+		//   Returns the engine for an event we got from the server or null if
+		//   the event should be ignored.
+		// </summary>
+		SingleSteppingEngine get_event_engine (int pid, int status)
+		{
+			SingleSteppingEngine engine = (SingleSteppingEngine) thread_hash [pid];
+			if ((engine != null) || !Inferior.HasThreadEvents)
+				return engine;
+
+			int arg;
+			Inferior.ChildEventType etype = mono_debugger_server_dispatch_simple (status, out arg);
+
+			/*
+			 * Ignore exit events from unknown children.
+			 */
+
+			if ((etype == Inferior.ChildEventType.CHILD_EXITED) && (arg == 0))
+				return null;
+
+			/*
+			 * There is a race condition in the Linux kernel which shows up on >= 2.6.27:
+			 *
+			 * When creating a new thread, the initial stopping event of that thread is sometimes
+			 * sent before sending the `PTRACE_EVENT_CLONE' for it.
+			 *
+			 * Because of this, we explicitly wait for the new thread to stop and ignore any
+			 * "early" stopping signals.
+			 *
+			 * See also the comments in _server_ptrace_wait_for_new_thread() in x86-linux-ptrace.c
+			 * and bugs #423518 and #466012.
+			 *
+			 */
+
+			if ((etype != Inferior.ChildEventType.CHILD_STOPPED) || (arg != 0)) {
+				Report.Error ("WARNING: Got event {0:x} for unknown pid {1}", status, pid);
+				return null;
+			}
+
+			if (!pending_sigstops.ContainsKey (pid))
+				pending_sigstops.Add (pid, DateTime.Now);
+
+			Report.Debug (DebugFlags.Wait, "Ignoring SIGSTOP from unknown pid {0}.", pid);
+			return null;
+		}
+
 		private void RequestWait ()
 		{
 			if (waiting)
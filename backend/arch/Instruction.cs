@@ -39,6 +39,14 @@ namespace Mono.Debugger.Architectures
 			get;
 		}
 
+		// <summary>
+		//   If this instruction has an IP-relative memory operand, the offset
+		//   of its 32-bit displacement in Code; otherwise -1.
+		// </summary>
+		public abstract int IpRelativeDisplacementOffset {
+			get;
+		}
+
 		public bool IsCall {
 			get {
 				return (InstructionType == Type.Call) ||
@@ -31,6 +31,13 @@ namespace Mono.Debugger.Architectures
 		public int Displacement;
 		public bool DereferenceAddress;
 
+		/* For ConditionalJump: the condition code of a Jcc or the opcode of a LOOP / JCXZ */
+		int condition = -1;
+		int loop_opcode;
+
+		/* Offset of the 32-bit displacement of a %rip-relative memory operand */
+		int ip_relative_offset = -1;
+
 		readonly TargetAddress address;
 		Type type = Type.Unknown;
 
@@ -53,7 +60,9 @@ namespace Mono.Debugger.Architectures
 					return true;
 
 				default:
-					return is_ip_relative;
+					// If we couldn't decode it, we can't tell - but we
+					// also don't know where its displacement is.
+					return is_ip_relative || (Is64BitMode && !fully_decoded);
 				}
 			}
 		}
@@ -80,7 +89,12 @@ namespace Mono.Debugger.Architectures
 			}
 		}
 
+		public override int IpRelativeDisplacementOffset {
+			get { return fully_decoded ? ip_relative_offset : -1; }
+		}
+
 		bool is_ip_relative;
+		bool fully_decoded = true;
 		bool has_insn_size;
 		int insn_size;
 		byte[] code;
@@ -293,6 +307,7 @@ namespace Mono.Debugger.Architectures
 
 			if (Is64BitMode && (ModRM.Mod == 0) && ((ModRM.R_M & 0x07) == 0x05)) {
 				is_ip_relative = true;
+				ip_relative_offset = (int) reader.Offset;
 			}
 		}
 
@@ -303,9 +318,11 @@ namespace Mono.Debugger.Architectures
 
 			if ((opcode >= 0x70) && (opcode <= 0x7f)) {
 				CallTarget = Address + reader.BinaryReader.ReadSByte () + 2;
+				condition = opcode & 0x0f;
 				type = Type.ConditionalJump;
 			} else if ((opcode >= 0xe0) && (opcode <= 0xe3)) {
 				CallTarget = Address + reader.BinaryReader.ReadSByte () + 2;
+				loop_opcode = opcode;
 				type = Type.ConditionalJump;
 			} else if ((opcode == 0xe8) || (opcode == 0xe9)) {
 				if ((RexPrefix & X86_REX_Prefix.REX_W) != 0) {
@@ -344,24 +361,28 @@ namespace Mono.Debugger.Architectures
 		{
 			byte opcode = reader.ReadByte ();
 
+			// Three-byte opcodes; we don't have ModRM tables for them.
+			if ((opcode == 0x38) || (opcode == 0x3a)) {
+				fully_decoded = false;
+				return;
+			}
+
 			if (TwoByte_Has_ModRM [opcode] != 0)
 				DecodeModRM (reader);
 
 			if ((opcode >= 0x80) && (opcode <= 0x8f)) {
-				if ((RexPrefix & X86_REX_Prefix.REX_W) != 0) {
-					long offset = reader.BinaryReader.ReadInt32 ();
-					long long_target = Address.Address + offset + 5;
-					CallTarget = new TargetAddress (
-						Address.Domain, long_target);
-				} else if ((Prefix & X86_Prefix.ADDR) != 0) {
+				// The displacement is relative to the end of the instruction,
+				// which also includes the 0x0f and any prefixes.
+				if (!Is64BitMode && ((Prefix & X86_Prefix.DATA) != 0)) {
 					short offset = reader.BinaryReader.ReadInt16 ();
-					int short_target = (short)Address.Address + offset + 3;
+					int short_target = (short) (Address.Address + reader.Offset + offset);
 					CallTarget = new TargetAddress (
 						Address.Domain, short_target);
 				} else {
 					int offset = reader.BinaryReader.ReadInt32 ();
-					CallTarget = Address + offset + 5;
+					CallTarget = Address + reader.Offset + offset;
 				}
+				condition = opcode & 0x0f;
 				type = Type.ConditionalJump;
 			}
 		}
@@ -471,6 +492,89 @@ namespace Mono.Debugger.Architectures
 			return effective_address;
 		}
 
+		const int CF = 1 << 0;
+		const int PF = 1 << 2;
+		const int ZF = 1 << 6;
+		const int SF = 1 << 7;
+		const int OF = 1 << 11;
+
+		// <summary>
+		//   Evaluate a conditional jump and set the instruction pointer
+		//   accordingly.
+		// </summary>
+		protected bool InterpretConditionalJump (Inferior inferior)
+		{
+			if (CallTarget.IsNull)
+				return false;
+
+			Registers regs = inferior.GetRegisters ();
+			bool taken;
+
+			if (condition >= 0) {
+				long flags = regs [(int) X86_Register.EFLAGS].GetValue ();
+
+				switch (condition >> 1) {
+				case 0:
+					taken = (flags & OF) != 0;
+					break;
+				case 1:
+					taken = (flags & CF) != 0;
+					break;
+				case 2:
+					taken = (flags & ZF) != 0;
+					break;
+				case 3:
+					taken = (flags & (CF | ZF)) != 0;
+					break;
+				case 4:
+					taken = (flags & SF) != 0;
+					break;
+				case 5:
+					taken = (flags & PF) != 0;
+					break;
+				case 6:
+					taken = ((flags & SF) != 0) != ((flags & OF) != 0);
+					break;
+				default:
+					taken = ((flags & ZF) != 0) ||
+						(((flags & SF) != 0) != ((flags & OF) != 0));
+					break;
+				}
+
+				// The odd condition codes are the negated ones.
+				if ((condition & 1) != 0)
+					taken = !taken;
+			} else {
+				// We'd need to truncate the counter.
+				if ((Prefix & X86_Prefix.ADDR) != 0)
+					return false;
+
+				long flags = regs [(int) X86_Register.EFLAGS].GetValue ();
+				long count = regs [(int) X86_Register.RCX].GetValue ();
+
+				if (loop_opcode == 0xe3) /* jcxz */ {
+					taken = count == 0;
+				} else {
+					if (!Is64BitMode)
+						count = (uint) (count - 1);
+					else
+						count--;
+					regs [(int) X86_Register.RCX].SetValue (count);
+
+					taken = count != 0;
+					if (loop_opcode == 0xe0) /* loopne */
+						taken &= (flags & ZF) == 0;
+					else if (loop_opcode == 0xe1) /* loope */
+						taken &= (flags & ZF) != 0;
+				}
+			}
+
+			TargetAddress rip = taken ? CallTarget : Address + InstructionSize;
+			regs [(int) X86_Register.RIP].SetValue (rip);
+			inferior.SetRegisters (regs);
+			return true;
+		}
+
 		public static X86_Instruction DecodeInstruction (X86_Opcodes opcodes,
 								 TargetMemoryAccess memory,
 								 TargetAddress address)
@@ -499,11 +603,21 @@ namespace Mono.Debugger.Architectures
 
 			byte opcode = reader.ReadByte ();
 
-			if (opcode == 0x0f)
+			//
+			// In 64-bit mode, 0xc4 / 0xc5 are VEX and 0x62 is an EVEX prefix,
+			// not LES / LDS / BOUND; an 0x8f whose ModRM.reg isn't zero is an
+			// XOP prefix, not POP.  We can't decode any of them.
+			//
+			if (Is64BitMode && ((opcode == 0xc4) || (opcode == 0xc5) || (opcode == 0x62)))
+				fully_decoded = false;
+			else if (opcode == 0x0f)
 				TwoByteOpcode (reader);
 			else
 				OneByteOpcode (reader, opcode);
 
+			if (Is64BitMode && (opcode == 0x8f) && ((ModRM.Reg & 0x07) != 0))
+				fully_decoded = false;
+
 			if (InstructionType != Type.Unknown) {
 				insn_size = (int) reader.Offset;
 				has_insn_size = true;
@@ -512,6 +626,11 @@ namespace Mono.Debugger.Architectures
 				has_insn_size = true;
 			}
 
+			// The disassembler may disagree with where we think the
+			// displacement is.
+			if ((ip_relative_offset >= 0) && (ip_relative_offset + 4 > insn_size))
+				fully_decoded = false;
+
 			if (has_insn_size) {
 				code = new byte [insn_size];
 				Array.Copy (reader.Contents, 0, code, 0, insn_size);
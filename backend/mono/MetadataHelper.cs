@@ -1,4 +1,5 @@
 using System;
+using System.Collections.Generic;
 
 using Mono.Debugger.Backend;
 using Mono.Debugger.Languages;
@@ -69,31 +70,92 @@ namespace Mono.Debugger.Backend.Mono
 		// MonoClass
 		//
 
+		Dictionary<long,MonoClassSnapshot> class_snapshots =
+			new Dictionary<long,MonoClassSnapshot> ();
+
+		// <summary>
+		//   Read the whole MonoClass at `klass' with one memory access.
+		//   Snapshots of initialized classes are cached for the lifetime of
+		//   the process (or until FlushClassCache() is called).
+		// </summary>
+		public MonoClassSnapshot GetClassSnapshot (TargetMemoryAccess memory,
+							   TargetAddress klass)
+		{
+			MonoClassSnapshot snapshot;
+			lock (class_snapshots) {
+				if (class_snapshots.TryGetValue (klass.Address, out snapshot))
+					return snapshot;
+			}
+
+			int addr_size = memory.TargetAddressSize;
+			TargetBinaryReader reader = memory.ReadMemory (
+				klass, MonoMetadataInfo.KlassSize).GetReader ();
+
+			snapshot = new MonoClassSnapshot (
+				klass,
+				peek_address (memory, reader, MonoMetadataInfo.KlassImageOffset),
+				reader.PeekInt32 (MonoMetadataInfo.KlassTokenOffset),
+				peek_address (memory, reader, MonoMetadataInfo.KlassParentOffset),
+				peek_address (memory, reader, MonoMetadataInfo.KlassGenericClassOffset),
+				peek_address (memory, reader, MonoMetadataInfo.KlassGenericContainerOffset),
+				reader.PeekInt32 (4 * addr_size),
+				reader.PeekInt32 (4 + 3 * addr_size),
+				peek_address (memory, reader, MonoMetadataInfo.KlassFieldOffset),
+				reader.PeekInt32 (MonoMetadataInfo.KlassFieldCountOffset),
+				peek_address (memory, reader, MonoMetadataInfo.KlassMethodsOffset),
+				reader.PeekInt32 (MonoMetadataInfo.KlassMethodCountOffset));
+
+			if (snapshot.IsComplete) {
+				lock (class_snapshots) {
+					class_snapshots [klass.Address] = snapshot;
+				}
+			}
+
+			return snapshot;
+		}
+
+		// <summary>
+		//   Forget all cached class snapshots; called when an appdomain is
+		//   unloaded since its classes are freed and their memory may be reused.
+		// </summary>
+		public void FlushClassCache ()
+		{
+			lock (class_snapshots) {
+				class_snapshots.Clear ();
+			}
+		}
+
+		static TargetAddress peek_address (TargetMemoryAccess memory, TargetBinaryReader reader,
+						   int offset)
+		{
+			long address = reader.PeekAddress (offset);
+			if (address == 0)
+				return TargetAddress.Null;
+			return new TargetAddress (memory.AddressDomain, address);
+		}
+
 		public TargetAddress MonoClassGetMonoImage (TargetMemoryAccess memory,
 							    TargetAddress klass)
 		{
-			return memory.ReadAddress (klass + MonoMetadataInfo.KlassImageOffset);
+			return GetClassSnapshot (memory, klass).Image;
 		}
 
 		public int MonoClassGetToken (TargetMemoryAccess memory,
 					      TargetAddress klass)
 		{
-			return memory.ReadInteger (klass + MonoMetadataInfo.KlassTokenOffset);
+			return GetClassSnapshot (memory, klass).Token;
 		}
 
 		public int MonoClassGetInstanceSize (TargetMemoryAccess memory,
 						     TargetAddress klass)
 		{
-			int flags = memory.ReadInteger (klass + 4 * memory.TargetAddressSize);
-
-			bool size_inited = (flags & 4) != 0;
-			bool valuetype = (flags & 8) != 0;
+			MonoClassSnapshot snapshot = GetClassSnapshot (memory, klass);
 
-			if (!size_inited)
+			if (!snapshot.SizeInited)
 				throw new TargetException (TargetError.ClassNotInitialized);
 
-			int size = memory.ReadInteger (klass + 4 + 3 * memory.TargetAddressSize);
-			if (valuetype)
+			int size = snapshot.InstanceSize;
+			if (snapshot.IsValueType)
 				size -= 2 * memory.TargetAddressSize;
 
 			return size;
@@ -102,19 +164,29 @@ namespace Mono.Debugger.Backend.Mono
 		public TargetAddress MonoClassGetParent (TargetMemoryAccess memory,
 							 TargetAddress klass)
 		{
-			return memory.ReadAddress (klass + MonoMetadataInfo.KlassParentOffset);
+			return GetClassSnapshot (memory, klass).Parent;
 		}
 
 		public TargetAddress MonoClassGetGenericClass (TargetMemoryAccess memory,
 							       TargetAddress klass)
 		{
-			return memory.ReadAddress (klass + MonoMetadataInfo.KlassGenericClassOffset);
+			return GetClassSnapshot (memory, klass).GenericClass;
 		}
 
 		public TargetAddress MonoClassGetGenericContainer (TargetMemoryAccess memory,
 								   TargetAddress klass)
 		{
-			return memory.ReadAddress (klass + MonoMetadataInfo.KlassGenericContainerOffset);
+			return GetClassSnapshot (memory, klass).GenericContainer;
+		}
+
+		public void MonoClassGetHierarchy (TargetMemoryAccess memory, TargetAddress klass,
+						   out TargetAddress parent, out TargetAddress generic_class,
+						   out TargetAddress generic_container)
+		{
+			MonoClassSnapshot snapshot = GetClassSnapshot (memory, klass);
+			parent = snapshot.Parent;
+			generic_class = snapshot.GenericClass;
+			generic_container = snapshot.GenericContainer;
 		}
 
 		public TargetAddress MonoClassGetByValType (TargetMemoryAccess memory,
@@ -125,61 +197,107 @@ namespace Mono.Debugger.Backend.Mono
 
 		public bool MonoClassHasFields (TargetMemoryAccess memory, TargetAddress klass)
 		{
-			TargetAddress fields = memory.ReadAddress (
-				klass + MonoMetadataInfo.KlassFieldOffset);
-			return !fields.IsNull;
+			return !GetClassSnapshot (memory, klass).Fields.IsNull;
 		}
 
 		public int MonoClassGetFieldCount (TargetMemoryAccess memory, TargetAddress klass)
 		{
-			return memory.ReadInteger (klass + MonoMetadataInfo.KlassFieldCountOffset);
+			return GetClassSnapshot (memory, klass).FieldCount;
 		}
 
-		public TargetAddress MonoClassGetFieldType (TargetMemoryAccess memory, TargetAddress klass,
-							    int index)
+		// <summary>
+		//   Read the type and offset of all the fields of a MonoClass at once
+		//   instead of doing two round-trips to the target per field.
+		// </summary>
+		public void MonoClassGetFields (TargetMemoryAccess memory, TargetAddress klass,
+						int count, out TargetAddress[] types, out int[] offsets)
 		{
-			int offset = index * MonoMetadataInfo.FieldInfoSize +
-				MonoMetadataInfo.FieldInfoTypeOffset;
+			MonoClassSnapshot snapshot = GetClassSnapshot (memory, klass);
+			read_field_array (memory, snapshot);
 
-			TargetAddress fields = memory.ReadAddress (
-				klass + MonoMetadataInfo.KlassFieldOffset);
-			if (fields.IsNull)
-				throw new TargetException (TargetError.ClassNotInitialized);
+			types = new TargetAddress [count];
+			offsets = new int [count];
+			Array.Copy (snapshot.FieldTypes, types, count);
+			Array.Copy (snapshot.FieldOffsets, offsets, count);
+		}
 
-			return memory.ReadAddress (fields + offset);
+		void read_field_array (TargetMemoryAccess memory, MonoClassSnapshot snapshot)
+		{
+			if (snapshot.HasFieldArray)
+				return;
+
+			int count = snapshot.FieldCount;
+			TargetAddress[] types = new TargetAddress [count];
+			int[] offsets = new int [count];
+
+			if (count > 0) {
+				if (snapshot.Fields.IsNull)
+					throw new TargetException (TargetError.ClassNotInitialized);
+
+				TargetBinaryReader reader = memory.ReadMemory (
+					snapshot.Fields, count * MonoMetadataInfo.FieldInfoSize).GetReader ();
+
+				for (int i = 0; i < count; i++) {
+					int pos = i * MonoMetadataInfo.FieldInfoSize;
+
+					types [i] = peek_address (
+						memory, reader, pos + MonoMetadataInfo.FieldInfoTypeOffset);
+					offsets [i] = reader.PeekInt32 (
+						pos + MonoMetadataInfo.FieldInfoOffsetOffset);
+				}
+			}
+
+			snapshot.SetFieldArray (types, offsets);
+		}
+
+		public TargetAddress MonoClassGetFieldType (TargetMemoryAccess memory, TargetAddress klass,
+							    int index)
+		{
+			MonoClassSnapshot snapshot = GetClassSnapshot (memory, klass);
+			read_field_array (memory, snapshot);
+			return snapshot.FieldTypes [index];
 		}
 
 		public int MonoClassGetFieldOffset (TargetMemoryAccess memory, TargetAddress klass,
 						    int index)
 		{
-			int offset = index * MonoMetadataInfo.FieldInfoSize +
-				MonoMetadataInfo.FieldInfoOffsetOffset;
+			MonoClassSnapshot snapshot = GetClassSnapshot (memory, klass);
+			read_field_array (memory, snapshot);
+			return snapshot.FieldOffsets [index];
+		}
 
-			TargetAddress fields = memory.ReadAddress (
-				klass + MonoMetadataInfo.KlassFieldOffset);
-			if (fields.IsNull)
-				throw new TargetException (TargetError.ClassNotInitialized);
+		//
+		// The runtime creates the method array on demand, so we need to read it
+		// from the target if it didn't exist yet when the snapshot was taken.
+		//
 
-			return memory.ReadInteger (fields + offset);
+		TargetAddress get_methods (TargetMemoryAccess memory, TargetAddress klass)
+		{
+			MonoClassSnapshot snapshot = GetClassSnapshot (memory, klass);
+			if (!snapshot.Methods.IsNull)
+				return snapshot.Methods;
+
+			return memory.ReadAddress (klass + MonoMetadataInfo.KlassMethodsOffset);
 		}
 
 		public bool MonoClassHasMethods (TargetMemoryAccess memory, TargetAddress klass)
 		{
-			TargetAddress methods = memory.ReadAddress (
-				klass + MonoMetadataInfo.KlassMethodsOffset);
-			return !methods.IsNull;
+			return !get_methods (memory, klass).IsNull;
 		}
 
 		public int MonoClassGetMethodCount (TargetMemoryAccess memory, TargetAddress klass)
 		{
+			MonoClassSnapshot snapshot = GetClassSnapshot (memory, klass);
+			if (!snapshot.Methods.IsNull)
+				return snapshot.MethodCount;
+
 			return memory.ReadInteger (klass + MonoMetadataInfo.KlassMethodCountOffset);
 		}
 
 		public TargetAddress MonoClassGetMethod (TargetMemoryAccess memory, TargetAddress klass,
 							 int index)
 		{
-			TargetAddress methods = memory.ReadAddress (
-				klass + MonoMetadataInfo.KlassMethodsOffset);
+			TargetAddress methods = get_methods (memory, klass);
 
 			if (methods.IsNull)
 				throw new TargetException (TargetError.ClassNotInitialized);
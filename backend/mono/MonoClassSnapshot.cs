@@ -0,0 +1,91 @@
+using System;
+
+namespace Mono.Debugger.Backend.Mono
+{
+	// <summary>
+	//   The contents of a MonoClass in the target, read with one single memory
+	//   access (see MetadataHelper.GetClassSnapshot()).
+	//
+	//   Once a class is initialized, its layout never changes, so MetadataHelper
+	//   caches these by klass address.  The field array is read on demand in a
+	//   second access.
+	// </summary>
+	internal sealed class MonoClassSnapshot
+	{
+		public readonly TargetAddress Klass;
+		public readonly TargetAddress Image;
+		public readonly int Token;
+		public readonly TargetAddress Parent;
+		public readonly TargetAddress GenericClass;
+		public readonly TargetAddress GenericContainer;
+		public readonly int Flags;
+		public readonly int InstanceSize;
+		public readonly TargetAddress Fields;
+		public readonly int FieldCount;
+		public readonly TargetAddress Methods;
+		public readonly int MethodCount;
+
+		TargetAddress[] field_types;
+		int[] field_offsets;
+
+		internal MonoClassSnapshot (TargetAddress klass, TargetAddress image, int token,
+					    TargetAddress parent, TargetAddress generic_class,
+					    TargetAddress generic_container, int flags,
+					    int instance_size, TargetAddress fields, int field_count,
+					    TargetAddress methods, int method_count)
+		{
+			this.Klass = klass;
+			this.Image = image;
+			this.Token = token;
+			this.Parent = parent;
+			this.GenericClass = generic_class;
+			this.GenericContainer = generic_container;
+			this.Flags = flags;
+			this.InstanceSize = instance_size;
+			this.Fields = fields;
+			this.FieldCount = field_count;
+			this.Methods = methods;
+			this.MethodCount = method_count;
+		}
+
+		public bool SizeInited {
+			get { return (Flags & 4) != 0; }
+		}
+
+		public bool IsValueType {
+			get { return (Flags & 8) != 0; }
+		}
+
+		// <summary>
+		//   Whether this snapshot may be cached: the class must be fully
+		//   initialized, otherwise the runtime may still fill in some fields.
+		// </summary>
+		public bool IsComplete {
+			get { return SizeInited && ((FieldCount == 0) || !Fields.IsNull); }
+		}
+
+		internal bool HasFieldArray {
+			get { return field_types != null; }
+		}
+
+		internal TargetAddress[] FieldTypes {
+			get { return field_types; }
+		}
+
+		internal int[] FieldOffsets {
+			get { return field_offsets; }
+		}
+
+		internal void SetFieldArray (TargetAddress[] types, int[] offsets)
+		{
+			field_types = types;
+			field_offsets = offsets;
+		}
+
+		public override string ToString ()
+		{
+			return String.Format ("MonoClassSnapshot ({0}:{1:x}:{2}:{3})", Klass, Token,
+					      FieldCount, MethodCount);
+		}
+	}
+}
@@ -216,6 +216,7 @@ namespace Mono.Debugger.Backend.Mono
 		Hashtable assembly_by_name;
 		Hashtable class_hash;
 		Dictionary<TargetAddress,MonoClassInfo> class_info_by_addr;
+		Dictionary<string,MonoSymbolFile> type_name_index;
 		MonoSymbolFile corlib;
 		MonoBuiltinTypeInfo builtin_types;
 		MonoFunctionType main_method;
@@ -713,6 +714,7 @@ namespace Mono.Debugger.Backend.Mono
 
 			symfile_by_image_addr.Add (symfile.MonoImage, symfile);
 			symfile_by_index.Add (symfile.Index, symfile);
+			flush_type_name_index ();
 
 			return symfile;
 		}
@@ -723,6 +725,56 @@ namespace Mono.Debugger.Backend.Mono
 			assembly_hash.Remove (symfile.Assembly);
 			assembly_by_name.Remove (symfile.Assembly.Name.FullName);
 			symfile_by_index.Remove (symfile.Index);
+			process.SymbolTableManager.RemoveSymbolFile (symfile);
+			flush_type_name_index ();
+		}
+
+		//
+		// Process-wide index from type name to the symbol file which defines
+		// that type, merged from the symbol files' own name indices.  It's
+		// discarded whenever an assembly is loaded or unloaded; if several
+		// assemblies define a type with the same name, the one which was
+		// loaded first wins.
+		//
+
+		void flush_type_name_index ()
+		{
+			lock (this) {
+				type_name_index = null;
+			}
+		}
+
+		Dictionary<string,MonoSymbolFile> get_type_name_index ()
+		{
+			lock (this) {
+				if (type_name_index != null)
+					return type_name_index;
+
+				List<int> indices = new List<int> ();
+				foreach (int index in symfile_by_index.Keys)
+					indices.Add (index);
+				indices.Sort ();
+
+				Dictionary<string,MonoSymbolFile> names;
+				names = new Dictionary<string,MonoSymbolFile> ();
+
+				foreach (int index in indices) {
+					MonoSymbolFile symfile = (MonoSymbolFile) symfile_by_index [index];
+					try {
+						foreach (string name in symfile.TypeNames) {
+							if (!names.ContainsKey (name))
+								names.Add (name, symfile);
+						}
+					} catch (Exception ex) {
+						Report.Debug (DebugFlags.JitSymtab,
+							      "Cannot index types in {0}: {1}",
+							      symfile, ex.Message);
+					}
+				}
+
+				type_name_index = names;
+				return type_name_index;
+			}
 		}
 
 		// This method reads the MonoDebuggerSymbolTable structure
@@ -1073,21 +1125,19 @@ namespace Mono.Debugger.Backend.Mono
 			if (name.IndexOf ('[') >= 0)
 				return null;
 
-			foreach (MonoSymbolFile symfile in symfile_by_index.Values) {
-				try {
-					var types = symfile.Assembly.MainModule.Types;
-					// FIXME: Work around an API problem in Cecil.
-					foreach (Cecil.TypeDefinition type in types) {
-						if (type.FullName != name)
-							continue;
+			MonoSymbolFile symfile;
+			if (!get_type_name_index ().TryGetValue (name, out symfile))
+				return null;
 
-						return symfile.LookupMonoType (type);
-					}
-				} catch {
-				}
-			}
+			try {
+				Cecil.TypeDefinition type = symfile.LookupTypeDefinition (name);
+				if (type == null)
+					return null;
 
-			return null;
+				return symfile.LookupMonoType (type);
+			} catch {
+				return null;
+			}
 		}
 
 		TargetFundamentalType GetFundamentalType (Type type)
@@ -1437,6 +1487,8 @@ namespace Mono.Debugger.Backend.Mono
 				Report.Debug (DebugFlags.JitSymtab,
 					      "Domain unload: {0} {1:x}", data, arg);
 				destroy_data_table ((int) arg, data);
+				MetadataHelper.FlushClassCache ();
+				process.SymbolTableManager.RemoveDomain ((int) arg);
 				engine.Process.BreakpointManager.DomainUnload (inferior, (int) arg);
 				break;
 
@@ -274,8 +274,6 @@ namespace Mono.Debugger.Backend.Mono
 				Console.WriteLine ("ASPX SOURCE: {0} {1}", this, File);
 			}
 #endif
-
-			process.SymbolTableManager.AddSymbolFile (this);
 		}
 
 		public override string ToString ()
@@ -328,24 +326,33 @@ namespace Mono.Debugger.Backend.Mono
 			get { return File != null; }
 		}
 
+		//
+		// We don't register ourselves with the SymbolTableManager; all our
+		// methods are JIT-compiled, so it gets each method's code range instead.
+		//
+		void add_range (RangeEntry range)
+		{
+			if (range_hash.Contains (range.Hash))
+				return;
+
+			range_hash.Add (range.Hash, range);
+			ranges.Add (range);
+			symtab.AddRange (range);
+			process.SymbolTableManager.AddMethodRange (this, range.Hash.Domain, range);
+		}
+
 		internal void AddRangeEntry (TargetMemoryAccess memory, TargetReader reader,
 					     byte[] contents)
 		{
 			RangeEntry range = RangeEntry.Create (this, memory, reader, contents);
-			if (!range_hash.Contains (range.Hash)) {
-				range_hash.Add (range.Hash, range);
-				ranges.Add (range);
-			}
+			add_range (range);
 		}
 
 		internal Method ReadRangeEntry (TargetMemoryAccess memory, TargetReader reader,
 						byte[] contents)
 		{
 			RangeEntry range = RangeEntry.Create (this, memory, reader, contents);
-			if (!range_hash.Contains (range.Hash)) {
-				range_hash.Add (range.Hash, range);
-				ranges.Add (range);
-			}
+			add_range (range);
 			return range.GetMethod ();
 		}
 
@@ -680,6 +687,86 @@ namespace Mono.Debugger.Backend.Mono
 			return sb.ToString ();
 		}
 
+		//
+		// Name index over all the types and methods in this assembly; built on
+		// first use.  Types are indexed by their Cecil full name and nested
+		// types also by their `Outer.Inner' and `Outer+Inner' forms.  Methods
+		// are indexed by `TypeName.MethodName', using any of the type's names.
+		//
+		Dictionary<string,Cecil.TypeDefinition> types_by_name;
+		Dictionary<string,List<Cecil.MethodDefinition>> methods_by_name;
+
+		static string[] get_type_names (Cecil.TypeDefinition type)
+		{
+			string name = type.FullName;
+			if (name.IndexOf ('/') < 0)
+				return new string[] { name };
+
+			return new string[] { name, name.Replace ('/', '.'), name.Replace ('/', '+') };
+		}
+
+		void add_to_name_index (Cecil.TypeDefinition type)
+		{
+			string[] names = get_type_names (type);
+			foreach (string name in names) {
+				if (!types_by_name.ContainsKey (name))
+					types_by_name.Add (name, type);
+			}
+
+			foreach (Cecil.MethodDefinition method in type.Methods) {
+				foreach (string name in names) {
+					string key = name + "." + method.Name;
+
+					List<Cecil.MethodDefinition> list;
+					if (!methods_by_name.TryGetValue (key, out list)) {
+						list = new List<Cecil.MethodDefinition> ();
+						methods_by_name.Add (key, list);
+					}
+					list.Add (method);
+				}
+			}
+
+			foreach (Cecil.TypeDefinition nested in type.NestedTypes)
+				add_to_name_index (nested);
+		}
+
+		void ensure_name_index ()
+		{
+			lock (this) {
+				if (types_by_name != null)
+					return;
+
+				types_by_name = new Dictionary<string,Cecil.TypeDefinition> ();
+				methods_by_name = new Dictionary<string,List<Cecil.MethodDefinition>> ();
+
+				var types = Assembly.MainModule.Types;
+				// FIXME: Work around an API problem in Cecil.
+				foreach (Cecil.TypeDefinition type in types)
+					add_to_name_index (type);
+			}
+		}
+
+		// <summary>
+		//   All the names under which LookupTypeDefinition() finds a type.
+		// </summary>
+		internal ICollection<string> TypeNames {
+			get {
+				ensure_name_index ();
+				return types_by_name.Keys;
+			}
+		}
+
+		internal Cecil.TypeDefinition LookupTypeDefinition (string name)
+		{
+			ensure_name_index ();
+
+			Cecil.TypeDefinition type;
+			if (types_by_name.TryGetValue (name, out type))
+				return type;
+
+			return null;
+		}
+
 		Cecil.MethodDefinition FindCecilMethod (string full_name)
 		{
 			string method_name, signature;
@@ -693,29 +780,21 @@ namespace Mono.Debugger.Backend.Mono
 				signature = null;
 			}
 
-			var types = Assembly.MainModule.Types;
-			// FIXME: Work around an API problem in Cecil.
-			foreach (Cecil.TypeDefinition type in types) {
-				if (!method_name.StartsWith (type.FullName))
-					continue;
+			ensure_name_index ();
 
-				if (method_name.Length <= type.FullName.Length)
-					continue;
-
-				string mname = method_name.Substring (type.FullName.Length + 1);
-				foreach (Cecil.MethodDefinition method in type.Methods) {
-					if (method.Name != mname)
-						continue;
+			List<Cecil.MethodDefinition> methods;
+			if (!methods_by_name.TryGetValue (method_name, out methods))
+				return null;
 
-					if (signature == null)
-						return method;
+			foreach (Cecil.MethodDefinition method in methods) {
+				if (signature == null)
+					return method;
 
-					string sig = GetMethodSignature (method);
-					if (sig != signature)
-						continue;
+				string sig = GetMethodSignature (method);
+				if (sig != signature)
+					continue;
 
-					return method;
-				}
+				return method;
 			}
 
 			return null;
@@ -771,18 +850,11 @@ namespace Mono.Debugger.Backend.Mono
 
 		internal MonoFunctionType GetFunctionType (string class_name, int token)
 		{
-			MonoClassType klass = null;
-
-			var types = Assembly.MainModule.Types;
-			// FIXME: Work around an API problem in Cecil.
-			foreach (Cecil.TypeDefinition type in types) {
-				if (type.FullName != class_name)
-					continue;
-
-				klass = LookupMonoClass (type);
-				break;
-			}
+			Cecil.TypeDefinition type = LookupTypeDefinition (class_name);
+			if (type == null)
+				return null;
 
+			MonoClassType klass = LookupMonoClass (type);
 			if (klass == null)
 				return null;
 
@@ -1641,17 +1713,28 @@ namespace Mono.Debugger.Backend.Mono
 
 			public override TargetAddress Lookup (int line)
 			{
-				if ((Addresses == null) || (line < StartRow) || (line > EndRow))
+				LineNumberTableData data = Data;
+				if ((data.Addresses == null) || (line < data.StartRow) || (line > data.EndRow))
 					return TargetAddress.Null;
 
-				for (int i = 0; i < Addresses.Length; i++) {
-					LineEntry entry = (LineEntry) Addresses [i];
-
-					if (line <= entry.Line)
-						return entry.Address;
+				//
+				// Find the first entry in address order whose line is at
+				// least `line'; since `MaxLine' is monotonic, that's the
+				// first one where `MaxLine' reaches it.
+				//
+				int lo = 0, hi = data.Addresses.Length;
+				while (lo < hi) {
+					int mid = (lo + hi) / 2;
+					if (data.MaxLine [mid] < line)
+						lo = mid + 1;
+					else
+						hi = mid;
 				}
 
-				return TargetAddress.Null;
+				if (lo == data.Addresses.Length)
+					return TargetAddress.Null;
+
+				return data.Addresses [lo].Address;
 			}
 
 			public override SourceAddress Lookup (TargetAddress address)
@@ -1659,33 +1742,34 @@ namespace Mono.Debugger.Backend.Mono
 				if (address.IsNull || (address < start) || (address >= end))
 					return null;
 
-				if (Addresses.Length < 1)
+				LineNumberTableData data = Data;
+				LineEntry[] addresses = data.Addresses;
+				if (addresses.Length < 1)
 					return null;
 
-				TargetAddress next_address = end;
-				TargetAddress next_not_hidden = end;
-
-				for (int i = Addresses.Length-1; i >= 0; i--) {
-					LineEntry entry = (LineEntry) Addresses [i];
-
-					int range = (int) (next_not_hidden - address);
-
-					next_address = entry.Address;
-					if (!entry.IsHidden)
-						next_not_hidden = entry.Address;
+				// Find the last entry at or before `address'.
+				int lo = 0, hi = addresses.Length;
+				while (lo < hi) {
+					int mid = (lo + hi) / 2;
+					if (addresses [mid].Address <= address)
+						lo = mid + 1;
+					else
+						hi = mid;
+				}
 
-					if (next_address > address)
-						continue;
+				if (lo == 0)
+					return create_address (addresses [0], (int) (address - start),
+							       (int) (addresses [0].Address - address));
 
-					int offset = (int) (address - next_address);
-					return create_address (entry, offset, range);
-				}
+				LineEntry entry = addresses [lo - 1];
 
-				if (Addresses.Length < 1)
-					return null;
+				TargetAddress next_not_hidden = data.NextVisible [lo - 1];
+				if (next_not_hidden.IsNull)
+					next_not_hidden = end;
 
-				return create_address (Addresses [0], (int) (address - start),
-						       (int) (Addresses [0].Address - address));
+				int offset = (int) (address - entry.Address);
+				int range = (int) (next_not_hidden - address);
+				return create_address (entry, offset, range);
 			}
 
 			SourceAddress create_address (LineEntry entry, int line_offset, int line_range)
@@ -1734,11 +1818,37 @@ namespace Mono.Debugger.Backend.Mono
 				public readonly int EndRow;
 				public readonly LineEntry[] Addresses;
 
+				// `MaxLine [i]' is the highest line in `Addresses [0]' ...
+				// `Addresses [i]'.
+				public readonly int[] MaxLine;
+
+				// `NextVisible [i]' is the address of the first entry after
+				// `Addresses [i]' which isn't hidden, or TargetAddress.Null.
+				public readonly TargetAddress[] NextVisible;
+
 				public LineNumberTableData (int start, int end, LineEntry[] addresses)
 				{
 					this.StartRow = start;
 					this.EndRow = end;
 					this.Addresses = addresses;
+
+					if (addresses == null)
+						return;
+
+					MaxLine = new int [addresses.Length];
+					int max_line = Int32.MinValue;
+					for (int i = 0; i < addresses.Length; i++) {
+						max_line = Math.Max (max_line, addresses [i].Line);
+						MaxLine [i] = max_line;
+					}
+
+					NextVisible = new TargetAddress [addresses.Length];
+					TargetAddress next = TargetAddress.Null;
+					for (int i = addresses.Length - 1; i >= 0; i--) {
+						NextVisible [i] = next;
+						if (!addresses [i].IsHidden)
+							next = addresses [i].Address;
+					}
 				}
 			}
 		}
@@ -2257,6 +2367,11 @@ namespace Mono.Debugger.Backend.Mono
 				this.file = file;
 			}
 
+			internal void AddRange (ISymbolRange range)
+			{
+				AddSymbolRange (range);
+			}
+
 			public override bool HasMethods {
 				get { return false; }
 			}
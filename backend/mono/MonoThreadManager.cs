@@ -113,6 +113,26 @@ namespace Mono.Debugger.Backend.Mono
 			private set;
 		}
 
+		TargetAddress code_buffer = TargetAddress.Null;
+
+		// <summary>
+		//   Whether an instruction at `address' whose IP-relative memory
+		//   operand has the 32-bit displacement `displacement' can still reach
+		//   its operand from anywhere in the code buffer.
+		// </summary>
+		internal bool CodeBufferCanReach (TargetAddress address, int displacement)
+		{
+			if (!HasCodeBuffer || code_buffer.IsNull)
+				return false;
+
+			long start = code_buffer.Address;
+			long end = start + debugger_info.ExecutableCodeBufferSize;
+
+			long min = displacement + address.Address - end;
+			long max = displacement + address.Address - start;
+			return (min >= Int32.MinValue) && (max <= Int32.MaxValue);
+		}
+
 		[DllImport("monodebuggerserver")]
 		static extern IntPtr mono_debugger_server_initialize_mono_runtime (
 			int address_size, long notification_address,
@@ -133,6 +153,7 @@ namespace Mono.Debugger.Backend.Mono
 			TargetAddress executable_code_buffer = inferior.ReadAddress (
 				debugger_info.ExecutableCodeBuffer);
 			HasCodeBuffer = !executable_code_buffer.IsNull;
+			code_buffer = executable_code_buffer;
 
 			mono_runtime_info = mono_debugger_server_initialize_mono_runtime (
 				inferior.TargetAddressSize,
@@ -160,6 +181,7 @@ namespace Mono.Debugger.Backend.Mono
 		internal void InitCodeBuffer (Inferior inferior, TargetAddress code_buffer)
 		{
 			HasCodeBuffer = true;
+			this.code_buffer = code_buffer;
 			mono_debugger_server_initialize_code_buffer (
 				mono_runtime_info, code_buffer.Address,
 				debugger_info.ExecutableCodeBufferSize);
@@ -22,10 +22,8 @@ namespace Mono.Debugger.Backend
 		protected BfdSymbolFile symfile;
 		TargetAddress entry_point = TargetAddress.Null;
 		bool is_loaded;
-		Hashtable symbols;
-		Hashtable local_symbols;
-		ArrayList simple_symbols;
-		BfdSymbolTable simple_symtab;
+		NativeSymbolTable symtab;
+		SymbolCache symbol_cache;
 		DwarfReader dwarf;
 		DwarfFrameReader frame_reader, eh_frame_reader;
 		bool dwarf_loaded;
@@ -39,6 +37,8 @@ namespace Mono.Debugger.Backend
 		TargetAddress plt_start, plt_end, got_start;
 		bool is_powerpc;
 		bool has_got;
+		MappedFile mapped_file;
+		bool mapping_failed;
 
 		[Flags]
 		internal enum SectionFlags {
@@ -73,10 +73,10 @@ namespace Mono.Debugger.Backend
 
 			object get_section_contents (object user_data)
 			{
-				byte[] data = bfd.GetSectionContents (section);
-				if (data == null)
+				TargetBlob blob = bfd.GetSectionBlob (section);
+				if (blob == null)
 					throw new SymbolTableException ("Can't get bfd section {0}", name);
-				return new TargetReader (data, bfd.info);
+				return new TargetReader (blob);
 			}
 
 			public TargetReader GetReader (TargetAddress address)
@@ -133,13 +133,10 @@ namespace Mono.Debugger.Backend
 		extern static IntPtr bfd_glue_openr_next_archived_file (IntPtr archive, IntPtr last);
 
 		[DllImport("monodebuggerserver")]
-		extern static int bfd_glue_get_symbols (IntPtr bfd, out IntPtr symtab);
-
-		[DllImport("monodebuggerserver")]
-		extern static int bfd_glue_get_dynamic_symbols (IntPtr bfd, out IntPtr symtab);
+		extern static bool bfd_glue_get_section_contents (IntPtr bfd, IntPtr section, IntPtr data, int size);
 
 		[DllImport("monodebuggerserver")]
-		extern static bool bfd_glue_get_section_contents (IntPtr bfd, IntPtr section, IntPtr data, int size);
+		extern static bool bfd_glue_get_section_file_range (IntPtr bfd, IntPtr section, out long offset, out int size);
 
 		[DllImport("monodebuggerserver")]
 		extern static IntPtr bfd_glue_get_first_section (IntPtr bfd);
@@ -165,13 +162,6 @@ namespace Mono.Debugger.Backend
 		[DllImport("monodebuggerserver")]
 		extern static long bfd_glue_get_start_address (IntPtr bfd);
 
-		[DllImport("libglib-2.0-0.dll")]
-		extern static void g_free (IntPtr data);
-
-		[DllImport("monodebuggerserver")]
-		extern static string bfd_glue_get_symbol (IntPtr bfd, IntPtr symtab, int index,
-							  out int is_function, out long address);
-
 		static Bfd ()
 		{
 			bfd_init ();
@@ -246,6 +236,8 @@ namespace Mono.Debugger.Backend
 							end_address = new TargetAddress (
 								info.AddressDomain, bss.vma + bss.size);
 					}
+
+					symbol_cache = open_symbol_cache ();
 				}
 
 				read_bfd_symbols ();
@@ -306,7 +298,15 @@ namespace Mono.Debugger.Backend
 				module.LoadModule (symfile);
 			}
 
-			os.Process.SymbolTableManager.AddSymbolFile (symfile);
+			if (IsContinuous)
+				os.Process.SymbolTableManager.AddSymbolFile (
+					symfile, start_address, end_address);
+			else
+				os.Process.SymbolTableManager.AddSymbolFile (symfile);
+
+			// The DwarfReader has already added its index if it's been loaded.
+			if (symbol_cache != null)
+				symbol_cache.Flush ();
 		}
 
 		public Bfd OpenCoreFile (string core_file)
@@ -316,70 +316,37 @@ namespace Mono.Debugger.Backend
 			return core;
 		}
 
-		void read_bfd_symbols ()
+		SymbolCache open_symbol_cache ()
 		{
-			IntPtr symtab;
-			int num_symbols = bfd_glue_get_symbols (bfd, out symtab);
-
-			symbols = new Hashtable ();
-			local_symbols = new Hashtable ();
-			simple_symbols = new ArrayList ();
-
-			bool is_mach = (bfd_glue_get_target_name (bfd) == "mach-o-le");
-
-			for (int i = 0; i < num_symbols; i++) {
-				string name;
-				long address;
-				int is_function;
-
-				name = bfd_glue_get_symbol (bfd, symtab, i, out is_function, out address);
-				if (name == null)
-					continue;
-
-				if(is_mach) {
-					if(name[0] == '_')
-						name = name.Substring(1);
-				}
-
-				TargetAddress relocated = new TargetAddress (
-					info.AddressDomain, base_address.Address + address);
-				if (is_function != 0 && !symbols.Contains (name))
-					symbols.Add (name, relocated);
-				else if (name.StartsWith ("MONO_DEBUGGER__") && !symbols.Contains (name))
-					symbols.Add (name, relocated);
-				else if (!local_symbols.Contains (name))
-					local_symbols.Add (name, relocated);
-
-				simple_symbols.Add (new Symbol (name, relocated, 0));
-			}
+			TargetBlob build_id = null;
+			if (HasSection (".note.gnu.build-id"))
+				build_id = GetSectionBlob (".note.gnu.build-id");
 
-			g_free (symtab);
-
-			num_symbols = bfd_glue_get_dynamic_symbols (bfd, out symtab);
-
-			for (int i = 0; i < num_symbols; i++) {
-				string name;
-				long address;
-				int is_function;
+			return SymbolCache.Open (
+				os.Process.Session.Config, filename, target, build_id, info);
+		}
 
-				name = bfd_glue_get_symbol (bfd, symtab, i, out is_function, out address);
-				if (name == null)
-					continue;
+		internal SymbolCache SymbolCache {
+			get { return symbol_cache; }
+		}
 
-				TargetAddress relocated = new TargetAddress (
-					info.AddressDomain,
-					base_address.Address + address);
-				simple_symbols.Add (new Symbol (name, relocated, 0));
+		void read_bfd_symbols ()
+		{
+			if ((symbol_cache != null) && symbol_cache.HasSymbols) {
+				symtab = symbol_cache.Symbols;
+				return;
 			}
 
-			g_free (symtab);
+			bool is_mach = (bfd_glue_get_target_name (bfd) == "mach-o-le");
+			symtab = NativeSymbolTable.Read (bfd, is_mach);
 
-			simple_symtab = new BfdSymbolTable (this);
+			if (symbol_cache != null)
+				symbol_cache.SetSymbols (symtab);
 		}
 
-		protected ArrayList GetSimpleSymbols ()
+		TargetAddress relocate (long address)
 		{
-			return simple_symbols;
+			return new TargetAddress (info.AddressDomain, base_address.Address + address);
 		}
 
 		internal TargetAddress ReadDynamicInfo (Inferior inferior)
@@ -515,10 +482,23 @@ namespace Mono.Debugger.Backend
 
 		protected Symbol SimpleLookup (TargetAddress address, bool exact_match)
 		{
-			if (simple_symtab != null)
-				return simple_symtab.SimpleLookup (address, exact_match);
+			if (symtab == null)
+				return null;
 
-			return null;
+			if (IsContinuous && ((address < StartAddress) || (address >= EndAddress)))
+				return null;
+
+			int index = symtab.LookupAddress (address.Address - base_address.Address);
+			if (index < 0)
+				return null;
+
+			long offset = address - relocate (symtab.Addresses [index]);
+			if (offset == 0)
+				return new Symbol (symtab.GetName (index), address, 0);
+			else if (exact_match)
+				return null;
+			else
+				return new Symbol (symtab.GetName (index), address - offset, (int) offset);
 		}
 
 		public override TargetAddress EntryPoint {
@@ -530,18 +510,25 @@ namespace Mono.Debugger.Backend
 			long vma_base = base_address.IsNull ? 0 : base_address.Address;
 			Section section = GetSectionByName (".debug_frame", false);
 			if (section != null) {
-				byte[] contents = GetSectionContents (section.section);
-				TargetBlob blob = new TargetBlob (contents, info);
+				TargetBlob blob = GetSectionBlob (section.section);
 				frame_reader = new DwarfFrameReader (
 					this, blob, vma_base + section.vma, false);
 			}
 
 			section = GetSectionByName (".eh_frame", false);
 			if (section != null) {
-				byte[] contents = GetSectionContents (section.section);
-				TargetBlob blob = new TargetBlob (contents, info);
-				eh_frame_reader = new DwarfFrameReader (
-					this, blob, vma_base + section.vma, true);
+				TargetBlob blob = GetSectionBlob (section.section);
+
+				Section hdr = GetSectionByName (".eh_frame_hdr", false);
+				if (hdr != null) {
+					TargetBlob hdr_blob = GetSectionBlob (hdr.section);
+					eh_frame_reader = new DwarfFrameReader (
+						this, blob, vma_base + section.vma,
+						hdr_blob, vma_base + hdr.vma);
+				} else {
+					eh_frame_reader = new DwarfFrameReader (
+						this, blob, vma_base + section.vma, true);
+				}
 			}
 		}
 
@@ -602,24 +589,26 @@ namespace Mono.Debugger.Backend
 
 		public override TargetAddress LookupSymbol (string name)
 		{
-			if (symbols == null)
+			if (symtab == null)
 				return TargetAddress.Null;
 
-			if (symbols.Contains (name))
-				return (TargetAddress) symbols [name];
+			int index = symtab.LookupGlobal (name);
+			if (index < 0)
+				return TargetAddress.Null;
 
-			return TargetAddress.Null;
+			return relocate (symtab.Addresses [index]);
 		}
 
 		public override TargetAddress LookupLocalSymbol (string name)
 		{
-			if (local_symbols == null)
+			if (symtab == null)
 				return TargetAddress.Null;
 
-			if (local_symbols.Contains (name))
-				return (TargetAddress) local_symbols [name];
+			int index = symtab.LookupLocal (name);
+			if (index < 0)
+				return TargetAddress.Null;
 
-			return TargetAddress.Null;
+			return relocate (symtab.Addresses [index]);
 		}
 
 		internal Section FindSection (long address)
@@ -754,10 +743,58 @@ namespace Mono.Debugger.Backend
 
 		public TargetReader GetSectionReader (string name)
 		{
-			byte[] contents = GetSectionContents (name);
-			if (contents == null)
-				throw new SymbolTableException ("Can't read bfd section {0}", name);
-			return new TargetReader (contents, info);
+			return new TargetReader (GetSectionBlob (name));
+		}
+
+		// <summary>
+		//   Returns the contents of a section as a TargetBlob.
+		//
+		//   If possible, this is a read-only view into a memory mapping of the
+		//   file, so the section is neither copied nor held on the managed heap
+		//   and the kernel can share its pages between all readers.  Sections
+		//   which need relocation or are compressed, archive members, core files
+		//   and files we may write to (see bfd_glue_map_file()) are copied.
+		//   The mapping is removed when this Bfd is disposed.
+		// </summary>
+		public TargetBlob GetSectionBlob (string name)
+		{
+			IntPtr section = bfd_get_section_by_name (bfd, name);
+			if (section == IntPtr.Zero)
+				throw new SymbolTableException ("Can't find bfd section {0}", name);
+
+			return GetSectionBlob (section);
+		}
+
+		TargetBlob GetSectionBlob (IntPtr section)
+		{
+			MappedFile file = get_mapped_file ();
+			if (file != null) {
+				long offset;
+				int size;
+
+				if (bfd_glue_get_section_file_range (bfd, section, out offset, out size) &&
+				    (offset + size <= file.Size))
+					return file.GetBlob (offset, size, info);
+			}
+
+			return new TargetBlob (GetSectionContents (section), info);
+		}
+
+		MappedFile get_mapped_file ()
+		{
+			lock (this) {
+				if ((mapped_file != null) || mapping_failed || is_coredump)
+					return mapped_file;
+
+				mapped_file = MappedFile.Create (filename);
+				if (mapped_file == null) {
+					Report.Debug (DebugFlags.SymbolTable, "{0} cannot map `{1}', falling " +
+						      "back to reading sections", this, filename);
+					mapping_failed = true;
+				}
+
+				return mapped_file;
+			}
 		}
 
 		byte[] GetSectionContents (IntPtr section)
@@ -1018,64 +1055,22 @@ namespace Mono.Debugger.Backend
 		// The BFD symbol table.
 		//
 
-		private class BfdSymbolTable
+		protected override void DoDispose ()
 		{
-			Bfd bfd;
-			Symbol[] list;
+			SymbolTableManager manager = os.Process.SymbolTableManager;
+			if (manager != null)
+				manager.RemoveSymbolFile (symfile);
 
-			public BfdSymbolTable (Bfd bfd)
-			{
-				this.bfd = bfd;
-			}
-
-			public Symbol SimpleLookup (TargetAddress address, bool exact_match)
-			{
-				if (bfd.IsContinuous &&
-				    ((address < bfd.StartAddress) || (address >= bfd.EndAddress)))
-					return null;
-
-				if (list == null) {
-					ArrayList the_list = bfd.GetSimpleSymbols ();
-					the_list.Sort ();
-
-					list = new Symbol [the_list.Count];
-					the_list.CopyTo (list);
-				}
-
-				for (int i = list.Length - 1; i >= 0; i--) {
-					Symbol entry = list [i];
-
-					if (address < entry.Address)
-						continue;
-
-					long offset = address - entry.Address;
-					if (offset == 0) {
-						while (i > 0) {
-							Symbol n_entry = list [--i];
-
-							if (n_entry.Address == entry.Address) 
-								entry = n_entry;
-							else
-								break;
-						}
-
-						return new Symbol (entry.Name, address, 0);
-					} else if (exact_match)
-						return null;
-					else
-						return new Symbol (
-							entry.Name, address - offset,
-							(int) offset);
-				}
+			bfd_close (bfd);
+			bfd = IntPtr.Zero;
 
-				return null;
+			lock (this) {
+				if (mapped_file != null)
+					mapped_file.Dispose ();
+				mapped_file = null;
+				mapping_failed = true;
 			}
-		}
 
-		protected override void DoDispose ()
-		{
-			bfd_close (bfd);
-			bfd = IntPtr.Zero;
 			base.DoDispose ();
 		}
 	}
@@ -18,6 +18,18 @@ namespace Mono.Debugger.Backend
 		[DllImport("monodebuggerserver")]
 		extern static int bfd_glue_disassemble_insn (IntPtr handle, long address);
 
+		[DllImport("monodebuggerserver")]
+		extern static int bfd_glue_disassemble_insn_buffered (IntPtr handle, long address, byte[] code, int code_size);
+
+		[DllImport("monodebuggerserver")]
+		extern static int bfd_glue_disassemble_buffer (IntPtr handle, long start, byte[] code, int code_size, out int size, out IntPtr data);
+
+		[DllImport("monodebuggerserver")]
+		extern static void bfd_glue_append_output (IntPtr handle, string output);
+
+		[DllImport("libglib-2.0-0.dll")]
+		extern static void g_free (IntPtr data);
+
 		[DllImport("monodebuggerserver")]
 		extern static IntPtr bfd_glue_create_disassembler (bool is_x86_64, ReadMemoryHandler read_memory_cb, OutputHandler output_cb, PrintAddressHandler print_address_cb);
 
@@ -59,16 +71,50 @@ namespace Mono.Debugger.Backend
 		}
 
 		StringBuilder sb;
+		bool native_output;
 		Exception memory_exception;
 		Method current_method;
 		TargetMemoryAccess memory;
 
 		void output_func (string output)
 		{
-			if (sb != null)
+			if (native_output)
+				bfd_glue_append_output (handle, output);
+			else if (sb != null)
 				sb.Append (output);
 		}
 
+		//
+		// An x86 instruction is at most 15 bytes long, so we prefetch that much
+		// (without crossing a page boundary) to avoid calling back into managed
+		// code for every single byte libopcodes wants to look at.  If an
+		// instruction is longer than the prefetched window, the rest is read
+		// through read_memory_func().
+		//
+
+		const int PrefetchSize = 16;
+		const int PageSize = 4096;
+
+		byte[] prefetch (TargetMemoryAccess memory, TargetAddress address)
+		{
+			int size = Math.Min (PrefetchSize, PageSize - (int) (address.Address & (PageSize - 1)));
+			try {
+				return memory.ReadBuffer (address, size);
+			} catch (TargetException) {
+				return null;
+			}
+		}
+
+		int disassemble_insn (TargetMemoryAccess memory, TargetAddress address)
+		{
+			byte[] code = prefetch (memory, address);
+			if (code == null)
+				return bfd_glue_disassemble_insn (handle, address.Address);
+
+			return bfd_glue_disassemble_insn_buffered (
+				handle, address.Address, code, code.Length);
+		}
+
 		void output_func (long address)
 		{
 			output_func (String.Format ("0x{0:x}", address));
@@ -108,7 +154,7 @@ namespace Mono.Debugger.Backend
 
 			try {
 				this.memory = memory;
-				int count = bfd_glue_disassemble_insn (handle, address.Address);
+				int count = disassemble_insn (memory, address);
 				if (memory_exception != null)
 					throw memory_exception;
 				return count;
@@ -121,6 +167,10 @@ namespace Mono.Debugger.Backend
 		public override AssemblerMethod DisassembleMethod (TargetMemoryAccess memory, Method method)
 		{
 			lock (this) {
+				AssemblerMethod retval = disassemble_method_buffered (memory, method);
+				if (retval != null)
+					return retval;
+
 				ArrayList list = new ArrayList ();
 				TargetAddress current = method.StartAddress;
 				while (current < method.EndAddress) {
@@ -140,6 +190,72 @@ namespace Mono.Debugger.Backend
 			}
 		}
 
+		//
+		// Read the whole method with one single memory access and let the
+		// server disassemble it in one go.
+		//
+		AssemblerMethod disassemble_method_buffered (TargetMemoryAccess memory, Method method)
+		{
+			int size = (int) (method.EndAddress - method.StartAddress);
+			if (size <= 0)
+				return null;
+
+			byte[] code;
+			try {
+				code = memory.ReadBuffer (method.StartAddress, size);
+			} catch (TargetException) {
+				return null;
+			}
+
+			int count, data_size;
+			IntPtr data;
+
+			memory_exception = null;
+			try {
+				this.memory = memory;
+				current_method = method;
+				native_output = true;
+				count = bfd_glue_disassemble_buffer (
+					handle, method.StartAddress.Address, code, size,
+					out data_size, out data);
+			} finally {
+				native_output = false;
+				this.memory = null;
+				memory_exception = null;
+				current_method = null;
+			}
+
+			try {
+				AssemblerLine[] lines = new AssemblerLine [count];
+				long pos = (long) data;
+				for (int i = 0; i < count; i++) {
+					int offset = Marshal.ReadInt32 ((IntPtr) pos);
+					int insn_size = Marshal.ReadInt32 ((IntPtr) (pos + 4));
+					int text_size = Marshal.ReadInt32 ((IntPtr) (pos + 8));
+					string insn = Marshal.PtrToStringAnsi ((IntPtr) (pos + 12));
+					pos += 12 + text_size + 1;
+
+					TargetAddress address = new TargetAddress (
+						memory.AddressDomain, method.StartAddress.Address + offset);
+
+					Symbol label = null;
+					if (process != null)
+						label = process.SymbolTableManager.SimpleLookup (address, true);
+
+					string label_name = null;
+					if (label != null)
+						label_name = label.ToString ();
+
+					lines [i] = new AssemblerLine (
+						label_name, address, (byte) insn_size, insn);
+				}
+
+				return new AssemblerMethod (method, lines);
+			} finally {
+				g_free (data);
+			}
+		}
+
 		public override AssemblerLine DisassembleInstruction (TargetMemoryAccess memory,
 								      Method method,
 								      TargetAddress address)
@@ -155,7 +271,7 @@ namespace Mono.Debugger.Backend
 				try {
 					this.memory = memory;
 					current_method = method;
-					insn_size = bfd_glue_disassemble_insn (handle, address.Address);
+					insn_size = disassemble_insn (memory, address);
 					if (memory_exception != null)
 						return null;
 					insn = sb.ToString ();
@@ -1,5 +1,6 @@
 using System;
 using System.Collections;
+using System.Collections.Generic;
 
 namespace Mono.Debugger.Backend
 {
@@ -9,7 +10,18 @@ namespace Mono.Debugger.Backend
 		protected readonly TargetBlob blob;
 		protected readonly bool is_ehframe;
 		protected readonly long vma;
-		protected CIE cie_list;
+		protected readonly TargetBlob hdr_blob;
+		protected readonly long hdr_vma;
+
+		Dictionary<long,CIE> cies = new Dictionary<long,CIE> ();
+
+		//
+		// All FDEs in this section, sorted by their initial location.  This is
+		// built on first use, either from the binary search table in the
+		// .eh_frame_hdr section or by scanning the whole section once.
+		//
+		long[] fde_start;
+		long[] fde_offset;
 
 		public DwarfFrameReader (Bfd bfd, TargetBlob blob, long vma,
 					 bool is_ehframe)
@@ -20,16 +32,24 @@ namespace Mono.Debugger.Backend
 			this.is_ehframe = is_ehframe;
 		}
 
+		public DwarfFrameReader (Bfd bfd, TargetBlob blob, long vma,
+					 TargetBlob hdr_blob, long hdr_vma)
+			: this (bfd, blob, vma, true)
+		{
+			this.hdr_blob = hdr_blob;
+			this.hdr_vma = hdr_vma;
+		}
+
 		protected CIE find_cie (long offset)
 		{
-			for (CIE cie = cie_list; cie != null; cie = cie.Next) {
-				if (cie.Offset == offset)
-					return cie;
+			lock (cies) {
+				CIE cie;
+				if (!cies.TryGetValue (offset, out cie)) {
+					cie = new CIE (this, offset);
+					cies.Add (offset, cie);
+				}
+				return cie;
 			}
-
-			CIE new_cie = new CIE (this, offset, cie_list);
-			cie_list = new_cie;
-			return cie_list;
 		}
 
 		public StackFrame UnwindStack (StackFrame frame, TargetMemoryAccess target,
@@ -40,54 +60,213 @@ namespace Mono.Debugger.Backend
 
 			TargetAddress address = frame.TargetAddress;
 
+			build_fde_table ();
+
+			int index = Array.BinarySearch (fde_start, address.Address);
+			if (index < 0)
+				index = ~index - 1;
+			if (index < 0)
+				return null;
+
+			DwarfBinaryReader reader = new DwarfBinaryReader (bfd, blob, false);
+			reader.Position = fde_offset [index];
+
+			long end_pos;
+			CIE cie = read_fde_header (reader, out end_pos);
+			if (cie == null)
+				return null;
+
+			long initial, range;
+			read_fde_range (reader, cie, out initial, out range);
+
+			TargetAddress start = new TargetAddress (target.AddressDomain, initial);
+
+			if ((address < start) || (address > start + range))
+				return null;
+
+			Entry fde = new Entry (cie, start, address);
+			fde.Read (reader, end_pos);
+			return fde.Unwind (frame, target, arch);
+		}
+
+		//
+		// Reads the header of the CIE or FDE at the reader's current position.
+		// Returns the FDE's CIE or null if this is a CIE or the terminator.
+		//
+		CIE read_fde_header (DwarfBinaryReader reader, out long end_pos)
+		{
+			long length = reader.ReadInitialLength ();
+			end_pos = reader.Position + length;
+			if (length == 0)
+				return null;
+
+			long id_pos = reader.Position;
+			long cie_pointer = reader.ReadOffset ();
+			bool is_cie;
+			if (is_ehframe)
+				is_cie = cie_pointer == 0;
+			else
+				is_cie = cie_pointer == -1;
+
+			if (is_cie)
+				return null;
+
+			// In .eh_frame, the CIE pointer is relative to its own location.
+			if (is_ehframe)
+				cie_pointer = id_pos - cie_pointer;
+
+			return find_cie (cie_pointer);
+		}
+
+		void read_fde_range (DwarfBinaryReader reader, CIE cie,
+				     out long initial, out long range)
+		{
+			if (is_ehframe) {
+				initial = ReadEncodedValue (reader, cie.Encoding);
+				range = ReadEncodedValue (reader, cie.Encoding & 0x0f);
+			} else {
+				initial = reader.ReadAddress ();
+				range = reader.ReadAddress ();
+			}
+		}
+
+		void build_fde_table ()
+		{
+			lock (this) {
+				if (fde_start != null)
+					return;
+
+				if ((hdr_blob == null) || !read_eh_frame_hdr ())
+					scan_fde_table ();
+			}
+		}
+
+		void scan_fde_table ()
+		{
+			List<long> starts = new List<long> ();
+			List<long> offsets = new List<long> ();
+
 			DwarfBinaryReader reader = new DwarfBinaryReader (bfd, blob, false);
 
 			while (reader.Position < reader.Size) {
-				long length = reader.ReadInitialLength ();
+				long offset = reader.Position;
+
+				long length = reader.PeekInt32 ();
 				if (length == 0)
 					break;
-				long end_pos = reader.Position + length;
 
-				long cie_pointer = reader.ReadOffset ();
-				bool is_cie;
-				if (is_ehframe)
-					is_cie = cie_pointer == 0;
-				else
-					is_cie = cie_pointer == -1;
+				long end_pos;
+				try {
+					CIE cie = read_fde_header (reader, out end_pos);
+					if (cie != null) {
+						long initial, range;
+						read_fde_range (reader, cie, out initial, out range);
 
-				if (is_cie) {
-					reader.Position = end_pos;
-					continue;
+						starts.Add (initial);
+						offsets.Add (offset);
+					}
+				} catch (DwarfException ex) {
+					// Skip FDEs we can't understand, but keep the others.
+					Report.Debug (DebugFlags.DwarfReader, "{0} cannot read FDE " +
+						      "at {1:x}: {2}", this, offset, ex.Message);
+					reader.Position = offset;
+					length = reader.ReadInitialLength ();
+					end_pos = reader.Position + length;
 				}
 
-				if (is_ehframe)
-					cie_pointer = reader.Position - cie_pointer -
-						target.TargetMemoryInfo.TargetAddressSize;
+				reader.Position = end_pos;
+			}
 
-				CIE cie = find_cie (cie_pointer);
+			fde_start = starts.ToArray ();
+			fde_offset = offsets.ToArray ();
+			Array.Sort (fde_start, fde_offset);
+		}
 
-				long initial, range;
-				if (is_ehframe) {
-					initial = ReadEncodedValue (reader, cie.Encoding);
-					range = ReadEncodedValue (reader, cie.Encoding & 0x0f);
-				} else {
-					initial = reader.ReadAddress ();
-					range = reader.ReadAddress ();
-				}
+		//
+		// The .eh_frame_hdr section contains a table of (initial location, FDE
+		// address) pairs which is already sorted by initial location.
+		//
+		bool read_eh_frame_hdr ()
+		{
+			DwarfBinaryReader reader = new DwarfBinaryReader (bfd, hdr_blob, false);
+
+			int version = reader.ReadByte ();
+			if (version != 1)
+				return false;
+
+			byte eh_frame_ptr_enc = reader.ReadByte ();
+			byte fde_count_enc = reader.ReadByte ();
+			byte table_enc = reader.ReadByte ();
+
+			if ((fde_count_enc == (byte) DW_EH_PE.omit) ||
+			    (table_enc == (byte) DW_EH_PE.omit))
+				return false;
+
+			long eh_frame_ptr;
+			if (!ReadHeaderValue (reader, eh_frame_ptr_enc, out eh_frame_ptr) ||
+			    (eh_frame_ptr != vma))
+				return false;
+
+			long count;
+			if (!ReadHeaderValue (reader, fde_count_enc, out count) ||
+			    (count < 0) || (count > blob.Size))
+				return false;
+
+			long[] starts = new long [count];
+			long[] offsets = new long [count];
+
+			for (int i = 0; i < count; i++) {
+				long fde_address;
+				if (!ReadHeaderValue (reader, table_enc, out starts [i]) ||
+				    !ReadHeaderValue (reader, table_enc, out fde_address))
+					return false;
+
+				offsets [i] = fde_address - vma;
+				if ((offsets [i] < 0) || (offsets [i] >= blob.Size))
+					return false;
+			}
 
-				TargetAddress start = new TargetAddress (target.AddressDomain, initial);
+			fde_start = starts;
+			fde_offset = offsets;
+			return true;
+		}
 
-				if ((address < start) || (address > start + range)) {
-					reader.Position = end_pos;
-					continue;
-				}
+		bool ReadHeaderValue (DwarfBinaryReader reader, byte encoding, out long value)
+		{
+			long base_addr;
+			switch (encoding & 0x70) {
+			case (byte) DW_EH_PE.absptr:
+				base_addr = 0;
+				break;
+			case (byte) DW_EH_PE.pcrel:
+				base_addr = hdr_vma + reader.Position;
+				break;
+			case (byte) DW_EH_PE.datarel:
+				base_addr = hdr_vma;
+				break;
+			default:
+				value = 0;
+				return false;
+			}
 
-				Entry fde = new Entry (cie, start, address);
-				fde.Read (reader, end_pos);
-				return fde.Unwind (frame, target, arch);
+			switch (encoding & 0x0f) {
+			case (byte) DW_EH_PE.udata4:
+				value = reader.ReadUInt32 ();
+				break;
+			case (byte) DW_EH_PE.sdata4:
+				value = reader.ReadInt32 ();
+				break;
+			case (byte) DW_EH_PE.udata8:
+			case (byte) DW_EH_PE.sdata8:
+				value = reader.ReadInt64 ();
+				break;
+			default:
+				value = 0;
+				return false;
 			}
 
-			return null;
+			value += base_addr;
+			return true;
 		}
 
 		private long ReadEncodedValue (DwarfBinaryReader reader, int encoding)
@@ -380,7 +559,6 @@ namespace Mono.Debugger.Backend
 		{
 			DwarfFrameReader frame;
 			long offset;
-			CIE next;
 
 			int code_alignment;
 			int data_alignment;
@@ -389,21 +567,17 @@ namespace Mono.Debugger.Backend
 			byte encoding = (byte) DW_EH_PE.udata4;
 			Column[] columns;
 
-			public CIE (DwarfFrameReader frame, long offset, CIE next)
+			public CIE (DwarfFrameReader frame, long offset)
 			{
 				this.frame = frame;
 				this.offset = offset;
-				this.next = next;
 
 				DwarfBinaryReader reader = new DwarfBinaryReader (
 					frame.bfd, frame.blob, false);
+				reader.Position = offset;
 				read_cie (reader);
 			}
 
-			public CIE Next {
-				get { return next; }
-			}
-
 			public Architecture Architecture {
 				get { return frame.bfd.Architecture; }
 			}
@@ -4,6 +4,7 @@ using System.Text;
 using System.Collections;
 using System.Collections.Generic;
 using System.Diagnostics;
+using ST = System.Threading;
 using System.Runtime.InteropServices;
 
 using Mono.Debugger.Languages;
@@ -158,18 +159,189 @@ namespace Mono.Debugger.Backend
 			method_hash = Hashtable.Synchronized (new Hashtable ());
 			source_file_hash = Hashtable.Synchronized (new Hashtable ());
 
-			if (bfd.IsLoaded) {
-				aranges = ArrayList.Synchronized (read_aranges ());
-				symtab = new DwarfSymbolTable (this, aranges);
-				pubnames = read_pubnames ();
-				// pubtypes = read_pubtypes ();
-			}
+			if (bfd.IsLoaded)
+				read_index ();
+
+			scan_compile_unit_blocks (reader);
+			ForEachBlock (null, false);
+		}
+
+		// <summary>
+		//   Reading the compile unit blocks is split across the thread pool.
+		//
+		//   On module load, we only do a quick serial scan over the block headers
+		//   and then let the workers create the CompileUnitBlocks.  Whoever needs a
+		//   block first creates it (see get_block()), so the engine thread only has
+		//   to wait if a worker is currently reading the block it's looking for.
+		// </summary>
+		const int MinParallelBlocks = 16;
+
+		long[] block_offsets;
+		Hashtable block_locks;
+
+		delegate void BlockFunc (CompileUnitBlock block);
+
+		void scan_compile_unit_blocks (DwarfBinaryReader reader)
+		{
+			ArrayList offsets = new ArrayList ();
+			block_locks = new Hashtable ();
 
 			long offset = 0;
 			while (offset < reader.Size) {
-				CompileUnitBlock block = new CompileUnitBlock (this, offset);
-				compile_unit_hash.Add (offset, block);
-				offset += block.length;
+				reader.Position = offset;
+				long length_field = reader.ReadInitialLength ();
+				long stop = reader.Position + length_field;
+
+				int version = reader.ReadInt16 ();
+				if (version < 2)
+					throw new DwarfException (
+						bfd, "Wrong DWARF version: {0}", version);
+
+				offsets.Add (offset);
+				block_locks.Add (offset, new object ());
+				offset = stop;
+			}
+
+			block_offsets = (long []) offsets.ToArray (typeof (long));
+		}
+
+		CompileUnitBlock get_block (long offset)
+		{
+			CompileUnitBlock block = (CompileUnitBlock) compile_unit_hash [offset];
+			if (block != null)
+				return block;
+
+			object block_lock = block_locks [offset];
+			if (block_lock == null)
+				return null;
+
+			lock (block_lock) {
+				block = (CompileUnitBlock) compile_unit_hash [offset];
+				if (block == null) {
+					block = new CompileUnitBlock (this, offset);
+					compile_unit_hash.Add (offset, block);
+				}
+				return block;
+			}
+		}
+
+		// <summary>
+		//   Run `func' on all compile unit blocks (or just create them if `func'
+		//   is null), using the thread pool for larger files.
+		//
+		//   If `wait' is true, the calling thread also walks all the blocks (in
+		//   reverse order, to stay out of the workers' way) and then waits for
+		//   the workers; since both get_block() and `func' only do their work
+		//   once, this either picks up blocks which no worker has started yet or
+		//   waits for the one which is currently working on it.  The first
+		//   exception from a worker is rethrown here.
+		//
+		//   Otherwise, errors are only logged; get_block() retries the failed
+		//   blocks when they're actually needed and reports the error then.
+		// </summary>
+		void ForEachBlock (BlockFunc func, bool wait)
+		{
+			int count = block_offsets.Length;
+			if (count < MinParallelBlocks) {
+				for (int i = count - 1; i >= 0; i--) {
+					CompileUnitBlock block = get_block (block_offsets [i]);
+					if (func != null)
+						func (block);
+				}
+				return;
+			}
+
+			//
+			// The section blobs are only created on demand by their ObjectCache,
+			// which isn't thread-safe - and neither is the libbfd code which may
+			// be used to read them.  So read them all here and keep them alive
+			// until the workers are done; the ObjectCache then gets them from
+			// its weak reference.
+			//
+			object[] sections = load_sections ();
+
+			int workers = Math.Max (Environment.ProcessorCount, 1);
+			int chunk = (count + workers - 1) / workers;
+			int pending = (count + chunk - 1) / chunk;
+			ST.ManualResetEvent done_event = wait ? new ST.ManualResetEvent (false) : null;
+			Exception error = null;
+
+			for (int start = 0; start < count; start += chunk) {
+				int first = start;
+				int last = Math.Min (start + chunk, count);
+				ST.ThreadPool.QueueUserWorkItem (delegate {
+					for (int i = first; i < last; i++) {
+						Exception ex = run_block_func (func, block_offsets [i]);
+						if (ex != null)
+							ST.Interlocked.CompareExchange (ref error, ex, null);
+					}
+
+					GC.KeepAlive (sections);
+					if ((ST.Interlocked.Decrement (ref pending) == 0) && (done_event != null))
+						done_event.Set ();
+				});
+			}
+
+			if (!wait)
+				return;
+
+			for (int i = count - 1; i >= 0; i--) {
+				CompileUnitBlock block = get_block (block_offsets [i]);
+				if (func != null)
+					func (block);
+			}
+
+			done_event.WaitOne ();
+			done_event.Close ();
+
+			if (error != null)
+				throw new DwarfException (bfd, "Failed to read compile unit block", error);
+		}
+
+		object[] load_sections ()
+		{
+			ObjectCache[] caches = {
+				debug_info_reader, debug_abbrev_reader, debug_line_reader,
+				debug_str_reader, debug_loc_reader, debug_ranges_reader
+			};
+
+			object[] sections = new object [caches.Length];
+			for (int i = 0; i < caches.Length; i++) {
+				if (caches [i] != null)
+					sections [i] = caches [i].Data;
+			}
+			return sections;
+		}
+
+		bool all_blocks_read;
+
+		// <summary>
+		//   Wait until all compile unit blocks are read, reading the ones
+		//   which no worker has started yet on the calling thread.
+		// </summary>
+		void read_all_blocks ()
+		{
+			if (all_blocks_read)
+				return;
+
+			for (int i = block_offsets.Length - 1; i >= 0; i--)
+				get_block (block_offsets [i]);
+
+			all_blocks_read = true;
+		}
+
+		Exception run_block_func (BlockFunc func, long offset)
+		{
+			try {
+				CompileUnitBlock block = get_block (offset);
+				if (func != null)
+					func (block);
+				return null;
+			} catch (Exception ex) {
+				Report.Debug (DebugFlags.DwarfReader,
+					      "Failed to read compile unit block {0} in {1}: {2}",
+					      offset, filename, ex.Message);
+				return ex;
 			}
 		}
 
@@ -178,13 +350,63 @@ namespace Mono.Debugger.Backend
 			if (aranges != null)
 				return;
 
-			aranges = ArrayList.Synchronized (read_aranges ());
-			symtab = new DwarfSymbolTable (this, aranges);
+			read_index ();
+		}
+
+		// <summary>
+		//   Read .debug_aranges and .debug_pubnames, or get them from the
+		//   Bfd's SymbolCache if we already have them there.
+		// </summary>
+		void read_index ()
+		{
+			SymbolCache cache = bfd.SymbolCache;
+
+			if ((cache != null) && cache.HasDwarfIndex) {
+				aranges = ArrayList.Synchronized (read_cached_aranges (cache));
+				pubnames = read_cached_pubnames (cache);
+			} else if (cache != null) {
+				ArrayList cached_aranges = new ArrayList ();
+				ArrayList cached_pubnames = new ArrayList ();
+
+				aranges = ArrayList.Synchronized (read_aranges (cached_aranges));
+				pubnames = read_pubnames (cached_pubnames);
+
+				cache.SetDwarfIndex (
+					(SymbolCache.RangeEntry []) cached_aranges.ToArray (
+						typeof (SymbolCache.RangeEntry)),
+					pubnames != null ? (SymbolCache.NameEntry []) cached_pubnames.ToArray (
+						typeof (SymbolCache.NameEntry)) : null);
+			} else {
+				aranges = ArrayList.Synchronized (read_aranges (null));
+				pubnames = read_pubnames (null);
+			}
 
-			pubnames = read_pubnames ();
+			symtab = new DwarfSymbolTable (this, aranges);
 			// pubtypes = read_pubtypes ();
 		}
 
+		ArrayList read_cached_aranges (SymbolCache cache)
+		{
+			ArrayList ranges = new ArrayList (cache.Aranges.Length);
+			foreach (SymbolCache.RangeEntry entry in cache.Aranges) {
+				TargetAddress address = GetAddress (entry.Address);
+				ranges.Add (new RangeEntry (this, entry.FileOffset, address, entry.Size));
+			}
+			return ranges;
+		}
+
+		Hashtable read_cached_pubnames (SymbolCache cache)
+		{
+			if (cache.Pubnames == null)
+				return null;
+
+			Hashtable names = Hashtable.Synchronized (
+				new Hashtable (cache.Pubnames.Length));
+			foreach (SymbolCache.NameEntry entry in cache.Pubnames)
+				names.Add (entry.Name, new NameEntry (entry.FileOffset, entry.Offset));
+			return names;
+		}
+
 		public static bool IsSupported (Bfd bfd)
 		{
 			if ((bfd.Target == "elf32-i386") || (bfd.Target == "elf64-x86-64"))
@@ -211,7 +433,7 @@ namespace Mono.Debugger.Backend
 
 		protected ISymbolTable get_symtab_at_offset (long offset)
 		{
-			CompileUnitBlock block = (CompileUnitBlock) compile_unit_hash [offset];
+			CompileUnitBlock block = get_block (offset);
 
 			// This either return the already-read symbol table or acquire the
 			// thread lock and read it.
@@ -220,6 +442,10 @@ namespace Mono.Debugger.Backend
 
 		public SourceFile[] Sources {
 			get {
+				// The source files are registered while reading the compile
+				// unit blocks, so make sure we have all of them.
+				read_all_blocks ();
+
 				SourceFile[] retval = new SourceFile [source_file_hash.Count];
 				source_file_hash.Values.CopyTo (retval, 0);
 				return retval;
@@ -238,7 +464,8 @@ namespace Mono.Debugger.Backend
 		{
 			ArrayList list = new ArrayList ();
 
-			foreach (CompileUnitBlock block in compile_unit_hash.Values) {
+			foreach (long offset in block_offsets) {
+				CompileUnitBlock block = get_block (offset);
 				foreach (CompilationUnit comp_unit in block.CompilationUnits) {
 					if (comp_unit.DieCompileUnit.SourceFile != file)
 						continue;
@@ -272,32 +499,40 @@ namespace Mono.Debugger.Backend
 			if (source != null)
 				return source;
 
-			CompileUnitBlock block = (CompileUnitBlock) compile_unit_hash [entry.FileOffset];
+			CompileUnitBlock block = get_block (entry.FileOffset);
+			if (block == null)
+				return null;
 			return block.GetMethod (entry.AbsoluteOffset);
 		}
 
 		protected DwarfMethodSource GetMethodSource (DieSubprogram subprog,
 							     int start_row, int end_row)
 		{
-			DwarfMethodSource source;
-			source = (DwarfMethodSource) method_source_hash [subprog.Offset];
-			if (source != null)
-				return source;
+			// Compile unit blocks may be read in parallel, so we need to lock
+			// the whole check-and-add, not just the hashtable.
+			lock (method_source_hash.SyncRoot) {
+				DwarfMethodSource source;
+				source = (DwarfMethodSource) method_source_hash [subprog.Offset];
+				if (source != null)
+					return source;
 
-			source = new DwarfMethodSource (subprog, start_row, end_row);
-			method_source_hash.Add (subprog.Offset, source);
-			return source;
+				source = new DwarfMethodSource (subprog, start_row, end_row);
+				method_source_hash.Add (subprog.Offset, source);
+				return source;
+			}
 		}
 
 		protected SourceFile GetSourceFile (string filename)
 		{
-			SourceFile file = (SourceFile) source_file_hash [filename];
-			if (file == null) {
-				file = new DwarfSourceFile (
-					bfd.NativeLanguage.Process.Session, module, filename);
-				source_file_hash.Add (filename, file);
+			lock (source_file_hash.SyncRoot) {
+				SourceFile file = (SourceFile) source_file_hash [filename];
+				if (file == null) {
+					file = new DwarfSourceFile (
+						bfd.NativeLanguage.Process.Session, module, filename);
+					source_file_hash.Add (filename, file);
+				}
+				return file;
 			}
-			return file;
 		}
 
 		protected void AddType (DieType type)
@@ -311,8 +546,9 @@ namespace Mono.Debugger.Backend
 			if (types_initialized)
 				return;
 
-			foreach (CompileUnitBlock block in compile_unit_hash.Values)
+			ForEachBlock (delegate (CompileUnitBlock block) {
 				block.ReadSymbolTable ();
+			}, true);
 
 			types_initialized = true;
 		}
@@ -527,6 +763,15 @@ namespace Mono.Debugger.Backend
 				throw new InvalidOperationException ();
 			}
 
+			public override Method Lookup (TargetAddress address)
+			{
+				SymbolRangeEntry range = LookupRange (ranges, address);
+				if (range == null)
+					return null;
+
+				return range.SymbolLookup.Lookup (address);
+			}
+
 			public ArrayList GetAllMethods ()
 			{
 				ArrayList methods = new ArrayList ();
@@ -576,7 +821,7 @@ namespace Mono.Debugger.Backend
 			}
 		}
 
-		ArrayList read_aranges ()
+		ArrayList read_aranges (ArrayList cached)
 		{
 			ArrayList ranges = new ArrayList ();
 
@@ -620,6 +865,9 @@ namespace Mono.Debugger.Backend
 
 					TargetAddress taddress = GetAddress (address);
 					ranges.Add (new RangeEntry (this, offset, taddress, size));
+
+					if (cached != null)
+						cached.Add (new SymbolCache.RangeEntry (offset, address, size));
 				}
 			}
 
@@ -648,7 +896,7 @@ namespace Mono.Debugger.Backend
 			}
 		}
 
-		Hashtable read_pubnames ()
+		Hashtable read_pubnames (ArrayList cached)
 		{
 			if (debug_pubnames_reader == null)
 				return null;
@@ -676,8 +924,13 @@ namespace Mono.Debugger.Backend
 						break;
 
 					string name = reader.ReadString ();
-					if (!names.Contains (name))
-						names.Add (name, new NameEntry (debug_offset, offset));
+					if (names.Contains (name))
+						continue;
+
+					names.Add (name, new NameEntry (debug_offset, offset));
+					if (cached != null)
+						cached.Add (new SymbolCache.NameEntry (
+							name, debug_offset, offset));
 				}
 			}
 
@@ -723,8 +976,7 @@ namespace Mono.Debugger.Backend
 		object create_reader_func (object user_data)
 		{
 			try {
-				byte[] contents = bfd.GetSectionContents ((string) user_data);
-				return new TargetBlob (contents, bfd.TargetMemoryInfo);
+				return bfd.GetSectionBlob ((string) user_data);
 			} catch {
 				Report.Debug (DebugFlags.DwarfReader,
 					      "{1} Can't find DWARF 2 debugging info in section `{0}'",
@@ -1048,6 +1300,8 @@ namespace Mono.Debugger.Backend
 			ArrayList lines;
 
 			LineNumber[] addresses;
+			// Indices into `addresses', sorted by line and then by address.
+			int[] line_index;
 
 			StatementMachine stm;
 
@@ -1250,6 +1504,14 @@ namespace Mono.Debugger.Backend
 				lines.Sort ();
 				addresses = new LineNumber [lines.Count];
 				lines.CopyTo (addresses, 0);
+
+				line_index = new int [addresses.Length];
+				for (int i = 0; i < line_index.Length; i++)
+					line_index [i] = i;
+				Array.Sort (line_index, delegate (int a, int b) {
+					int result = addresses [a].Line.CompareTo (addresses [b].Line);
+					return result != 0 ? result : a.CompareTo (b);
+				});
 			}
 
 			protected void Read ()
@@ -1359,61 +1621,53 @@ namespace Mono.Debugger.Backend
 
 			public override TargetAddress Lookup (int line)
 			{
-				for (int i = 0; i < addresses.Length; i++) {
-					LineNumber entry = (LineNumber) addresses [i];
-
-					if (entry.Line != line)
-						continue;
-
-					return comp_unit.dwarf.GetAddress (entry.Offset);
+				// Find the first entry for `line' in address order.
+				int lo = 0, hi = line_index.Length;
+				while (lo < hi) {
+					int mid = (lo + hi) / 2;
+					if (addresses [line_index [mid]].Line < line)
+						lo = mid + 1;
+					else
+						hi = mid;
 				}
 
-				return TargetAddress.Null;
+				if ((lo == line_index.Length) || (addresses [line_index [lo]].Line != line))
+					return TargetAddress.Null;
+
+				return comp_unit.dwarf.GetAddress (addresses [line_index [lo]].Offset);
 			}
 
-			SourceAddress do_lookup (TargetAddress address, int start_pos, int end_pos)
+			public override SourceAddress Lookup (TargetAddress address)
 			{
-				if (end_pos - start_pos >= 4) {
-					int middle_pos = (start_pos + end_pos) / 2;
-					LineNumber middle = (LineNumber) addresses [middle_pos];
-
-					TargetAddress maddr = comp_unit.dwarf.GetAddress (middle.Offset);
-					if (address < maddr)
-						return do_lookup (address, start_pos, middle_pos);
+				// Find the last entry at or before `address'.
+				int lo = 0, hi = addresses.Length;
+				while (lo < hi) {
+					int mid = (lo + hi) / 2;
+					TargetAddress maddr = comp_unit.dwarf.GetAddress (addresses [mid].Offset);
+					if (maddr <= address)
+						lo = mid + 1;
 					else
-						return do_lookup (address, middle_pos, end_pos);
+						hi = mid;
 				}
 
-				TargetAddress next_address;
-				if (end_pos == addresses.Length)
-					next_address = comp_unit.EndAddress;
-				else {
-					LineNumber end_line = addresses [end_pos];
-					next_address = comp_unit.dwarf.GetAddress (end_line.Offset);
-				}
-
-				for (int i = end_pos-1; i >= start_pos; i--) {
-					LineNumber line = addresses [i];
-
-					int range = (int) (next_address - address);
-					next_address = comp_unit.dwarf.GetAddress (line.Offset);
-
-					if (next_address > address)
-						continue;
+				if (lo == 0)
+					return null;
 
-					int offset = (int) (address - next_address);
+				LineNumber line = addresses [lo - 1];
 
-					FileEntry file = (FileEntry) source_files [line.File - 1];
-					return new SourceAddress (
-						file.File, null, line.Line, offset, range);
-				}
+				TargetAddress next_address;
+				if (lo == addresses.Length)
+					next_address = comp_unit.EndAddress;
+				else
+					next_address = comp_unit.dwarf.GetAddress (addresses [lo].Offset);
 
-				return null;
-			}
+				TargetAddress line_address = comp_unit.dwarf.GetAddress (line.Offset);
+				int offset = (int) (address - line_address);
+				int range = (int) (next_address - address);
 
-			public override SourceAddress Lookup (TargetAddress address)
-			{
-				return do_lookup (address, 0, addresses.Length-1);
+				FileEntry file = (FileEntry) source_files [line.File - 1];
+				return new SourceAddress (
+					file.File, null, line.Line, offset, range);
 			}
 
 			public override bool HasMethodBounds {
@@ -2723,7 +2977,7 @@ namespace Mono.Debugger.Backend
 
 				source = subprog.dwarf.GetMethodSource (subprog, start_row, end_row);
 
-				subprog.dwarf.method_hash.Add (source.Handle, this);
+				subprog.dwarf.method_hash [source.Handle] = this;
 			}
 
 			public bool CheckLoaded ()
@@ -0,0 +1,83 @@
+using System;
+using System.Runtime.InteropServices;
+
+namespace Mono.Debugger.Backend
+{
+	// <summary>
+	//   A read-only memory mapping of a whole file.
+	//
+	//   TargetBlobs which are created from it keep a reference to it, so the
+	//   mapping isn't removed by the finalizer while anyone is still reading
+	//   from it.  The owner should Dispose() it once all these blobs are
+	//   gone, reading from them afterwards is not allowed.
+	// </summary>
+	internal sealed class MappedFile : IDisposable
+	{
+		[DllImport("monodebuggerserver")]
+		extern static IntPtr bfd_glue_map_file (string filename, out long size);
+
+		[DllImport("monodebuggerserver")]
+		extern static void bfd_glue_unmap_file (IntPtr address, long size);
+
+		public readonly string FileName;
+
+		IntPtr address;
+		long size;
+
+		MappedFile (string filename, IntPtr address, long size)
+		{
+			this.FileName = filename;
+			this.address = address;
+			this.size = size;
+		}
+
+		public static MappedFile Create (string filename)
+		{
+			long size;
+			IntPtr address = bfd_glue_map_file (filename, out size);
+			if (address == IntPtr.Zero)
+				return null;
+
+			return new MappedFile (filename, address, size);
+		}
+
+		public long Size {
+			get { return size; }
+		}
+
+		public TargetBlob GetBlob (long offset, int size, TargetMemoryInfo info)
+		{
+			if (address == IntPtr.Zero)
+				throw new ObjectDisposedException ("MappedFile");
+			if ((offset < 0) || (size < 0) || (offset + size > this.size))
+				throw new ArgumentOutOfRangeException ();
+
+			return new TargetBlob (this, (IntPtr) ((long) address + offset), size, info);
+		}
+
+		void unmap ()
+		{
+			lock (this) {
+				if (address != IntPtr.Zero)
+					bfd_glue_unmap_file (address, size);
+				address = IntPtr.Zero;
+			}
+		}
+
+		public void Dispose ()
+		{
+			unmap ();
+			GC.SuppressFinalize (this);
+		}
+
+		~MappedFile ()
+		{
+			unmap ();
+		}
+
+		public override string ToString ()
+		{
+			return String.Format ("MappedFile ({0}:{1})", FileName, size);
+		}
+	}
+}
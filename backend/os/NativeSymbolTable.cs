@@ -0,0 +1,225 @@
+using System;
+using System.Text;
+using System.Runtime.InteropServices;
+
+namespace Mono.Debugger.Backend
+{
+	// <summary>
+	//   The static and dynamic ELF symbol tables of a Bfd.
+	//
+	//   bfd_glue_read_symbol_table() reads both tables in one single call and
+	//   gives us flat arrays: addresses, name offsets and flags sorted by
+	//   address, plus an index which is sorted by name, and all the names in
+	//   one string blob.  We keep them exactly like this instead of creating
+	//   one object per symbol; lookups by address and by name are binary
+	//   searches and names are only decoded when a lookup returns them.
+	//
+	//   All addresses are unrelocated.
+	// </summary>
+	internal sealed class NativeSymbolTable
+	{
+		[Flags]
+		public enum SymbolFlags {
+			Function	= 1,
+			Dynamic		= 2,
+			// Static function or MONO_DEBUGGER__ symbol.
+			Global		= 4
+		}
+
+		[StructLayout(LayoutKind.Sequential)]
+		struct BfdGlueSymbolTable
+		{
+			public int Count;
+			public int StringsSize;
+			public IntPtr Addresses;
+			public IntPtr Names;
+			public IntPtr Flags;
+			public IntPtr NameOrder;
+			public IntPtr Strings;
+		}
+
+		[DllImport("monodebuggerserver")]
+		extern static IntPtr bfd_glue_read_symbol_table (IntPtr bfd, bool strip_underscore);
+
+		[DllImport("monodebuggerserver")]
+		extern static void bfd_glue_free_symbol_table (IntPtr table);
+
+		public readonly long[] Addresses;
+		public readonly int[] Names;
+		public readonly int[] Flags;
+		public readonly int[] NameOrder;
+		public readonly byte[] Strings;
+
+		public NativeSymbolTable (long[] addresses, int[] names, int[] flags,
+					  int[] name_order, byte[] strings)
+		{
+			this.Addresses = addresses;
+			this.Names = names;
+			this.Flags = flags;
+			this.NameOrder = name_order;
+			this.Strings = strings;
+		}
+
+		public static NativeSymbolTable Read (IntPtr bfd, bool strip_underscore)
+		{
+			IntPtr data = bfd_glue_read_symbol_table (bfd, strip_underscore);
+			try {
+				BfdGlueSymbolTable table = (BfdGlueSymbolTable) Marshal.PtrToStructure (
+					data, typeof (BfdGlueSymbolTable));
+
+				int count = table.Count;
+				long[] addresses = new long [count];
+				int[] names = new int [count];
+				int[] flags = new int [count];
+				int[] name_order = new int [count];
+				byte[] strings = new byte [table.StringsSize];
+
+				if (count > 0) {
+					Marshal.Copy (table.Addresses, addresses, 0, count);
+					Marshal.Copy (table.Names, names, 0, count);
+					Marshal.Copy (table.Flags, flags, 0, count);
+					Marshal.Copy (table.NameOrder, name_order, 0, count);
+				}
+				if (strings.Length > 0)
+					Marshal.Copy (table.Strings, strings, 0, strings.Length);
+
+				return new NativeSymbolTable (addresses, names, flags, name_order, strings);
+			} finally {
+				bfd_glue_free_symbol_table (data);
+			}
+		}
+
+		public int Count {
+			get { return Addresses.Length; }
+		}
+
+		public string GetName (int index)
+		{
+			int start = Names [index];
+			int end = Array.IndexOf (Strings, (byte) 0, start);
+			return Encoding.UTF8.GetString (Strings, start, end - start);
+		}
+
+		// <summary>
+		//   Returns the index of the symbol at or before `address' or -1.  If
+		//   several symbols have the same address, the first one wins.
+		// </summary>
+		public int LookupAddress (long address)
+		{
+			// Find the first symbol above `address'.
+			int lo = 0, hi = Addresses.Length;
+			while (lo < hi) {
+				int mid = (lo + hi) / 2;
+				if (Addresses [mid] <= address)
+					lo = mid + 1;
+				else
+					hi = mid;
+			}
+
+			if (lo == 0)
+				return -1;
+
+			int index = lo - 1;
+			while ((index > 0) && (Addresses [index - 1] == Addresses [index]))
+				index--;
+			return index;
+		}
+
+		// <summary>
+		//   Look up a static function or MONO_DEBUGGER__ symbol; if there
+		//   are several of them, the first one in the symbol table wins.
+		// </summary>
+		public int LookupGlobal (string name)
+		{
+			byte[] key = Encoding.UTF8.GetBytes (name);
+			int pos = find_name (key);
+			if (pos < 0)
+				return -1;
+
+			for (; pos < NameOrder.Length; pos++) {
+				int index = NameOrder [pos];
+				if (compare_name (index, key) != 0)
+					break;
+				if ((Flags [index] & (int) SymbolFlags.Global) != 0)
+					return index;
+			}
+
+			return -1;
+		}
+
+		// <summary>
+		//   Look up any other static symbol: the first one in the symbol
+		//   table which isn't returned by LookupGlobal().
+		// </summary>
+		public int LookupLocal (string name)
+		{
+			byte[] key = Encoding.UTF8.GetBytes (name);
+			int pos = find_name (key);
+			if (pos < 0)
+				return -1;
+
+			bool global_found = false;
+			for (; pos < NameOrder.Length; pos++) {
+				int index = NameOrder [pos];
+				if (compare_name (index, key) != 0)
+					break;
+
+				int flags = Flags [index];
+				if ((flags & (int) SymbolFlags.Dynamic) != 0)
+					continue;
+				if (!global_found && ((flags & (int) SymbolFlags.Global) != 0)) {
+					global_found = true;
+					continue;
+				}
+
+				return index;
+			}
+
+			return -1;
+		}
+
+		// <summary>
+		//   Returns the position of the first entry in NameOrder whose name
+		//   is `key' or -1.
+		// </summary>
+		int find_name (byte[] key)
+		{
+			int lo = 0, hi = NameOrder.Length;
+			while (lo < hi) {
+				int mid = (lo + hi) / 2;
+				if (compare_name (NameOrder [mid], key) < 0)
+					lo = mid + 1;
+				else
+					hi = mid;
+			}
+
+			if ((lo < NameOrder.Length) && (compare_name (NameOrder [lo], key) == 0))
+				return lo;
+
+			return -1;
+		}
+
+		// <summary>
+		//   Compares the name of symbol `index' with `key' like strcmp(),
+		//   which is how bfd_glue_read_symbol_table() sorted them.
+		// </summary>
+		int compare_name (int index, byte[] key)
+		{
+			int pos = Names [index];
+			for (int i = 0; ; i++, pos++) {
+				int a = Strings [pos];
+				int b = i < key.Length ? key [i] : 0;
+
+				if (a != b)
+					return a - b;
+				if (a == 0)
+					return 0;
+			}
+		}
+
+		public override string ToString ()
+		{
+			return String.Format ("NativeSymbolTable ({0})", Count);
+		}
+	}
+}
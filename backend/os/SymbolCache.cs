@@ -0,0 +1,475 @@
+using System;
+using System.IO;
+using System.Text;
+using System.Collections;
+using System.Security.Cryptography;
+
+namespace Mono.Debugger.Backend
+{
+	// <summary>
+	//   A persistent on-disk index of a native module's symbol table (static
+	//   and dynamic), its .debug_aranges and its .debug_pubnames.
+	//
+	//   There is one file per module in the cache directory, named after the
+	//   module's build-id (or a hash of its path if it doesn't have one).  The
+	//   file contains sorted arrays with unrelocated addresses plus a string
+	//   table, so on a warm start we only need to read it and copy out the arrays
+	//   instead of reading the ELF symbol table and parsing the DWARF sections.
+	//
+	//   All data is optional: the file is written once the Bfd has read the
+	//   symbol tables and the DWARF index (if it's read while loading the
+	//   module), and again if the DwarfReader reads the index later.  An entry
+	//   is considered stale if the module's build-id, size or modification time
+	//   (without a build-id) doesn't match.  The cache is strictly best-effort:
+	//   any error while reading or writing it just disables it for the module.
+	// </summary>
+	internal class SymbolCache
+	{
+		public struct RangeEntry
+		{
+			public readonly long FileOffset;
+			public readonly long Address;
+			public readonly long Size;
+
+			public RangeEntry (long file_offset, long address, long size)
+			{
+				this.FileOffset = file_offset;
+				this.Address = address;
+				this.Size = size;
+			}
+		}
+
+		public struct NameEntry
+		{
+			public readonly string Name;
+			public readonly long FileOffset;
+			public readonly long Offset;
+
+			public NameEntry (string name, long file_offset, long offset)
+			{
+				this.Name = name;
+				this.FileOffset = file_offset;
+				this.Offset = offset;
+			}
+		}
+
+		const int Magic = 0x4d445343;		// "MDSC"
+		const int Version = 2;
+
+		public readonly string FileName;
+		public readonly string CacheFileName;
+
+		string target;
+		string build_id;
+		long size;
+		long mtime;
+		TargetMemoryInfo info;
+
+		NativeSymbolTable symbols;
+		RangeEntry[] aranges;
+		NameEntry[] pubnames;
+		bool dirty;
+
+		SymbolCache (string filename, string cache_file, string target,
+			     string build_id, long size, long mtime, TargetMemoryInfo info)
+		{
+			this.FileName = filename;
+			this.CacheFileName = cache_file;
+			this.target = target;
+			this.build_id = build_id;
+			this.size = size;
+			this.mtime = mtime;
+			this.info = info;
+		}
+
+		// <summary>
+		//   Returns the cache entry for `filename', reading it from the cache
+		//   directory if it's there and still valid.  Returns null if the cache
+		//   is disabled or can't be used for this file.
+		// </summary>
+		public static SymbolCache Open (DebuggerConfiguration config, string filename,
+						string target, TargetBlob build_id_note,
+						TargetMemoryInfo info)
+		{
+			if (!config.SymbolCache)
+				return null;
+
+			SymbolCache cache;
+			try {
+				FileInfo fi = new FileInfo (filename);
+				if (!fi.Exists)
+					return null;
+
+				string build_id = read_build_id (build_id_note);
+				string key = build_id ?? hash_file_name (fi.FullName);
+
+				string cache_file = Path.Combine (
+					config.SymbolCacheDirectory, key + ".symidx");
+
+				cache = new SymbolCache (
+					fi.FullName, cache_file, target, build_id ?? "",
+					fi.Length, fi.LastWriteTimeUtc.Ticks, info);
+			} catch (Exception ex) {
+				Report.Debug (DebugFlags.SymbolTable,
+					      "Cannot use symbol cache for {0}: {1}", filename, ex.Message);
+				return null;
+			}
+
+			try {
+				if (File.Exists (cache.CacheFileName))
+					cache.read ();
+			} catch (Exception ex) {
+				Report.Debug (DebugFlags.SymbolTable,
+					      "Ignoring invalid symbol cache {0}: {1}",
+					      cache.CacheFileName, ex.Message);
+				cache.clear ();
+			}
+
+			return cache;
+		}
+
+		public bool HasSymbols {
+			get { return symbols != null; }
+		}
+
+		public bool HasDwarfIndex {
+			get { return aranges != null; }
+		}
+
+		public NativeSymbolTable Symbols {
+			get { return symbols; }
+		}
+
+		public RangeEntry[] Aranges {
+			get { return aranges; }
+		}
+
+		// <summary>
+		//   May be null if the module has aranges, but no .debug_pubnames.
+		// </summary>
+		public NameEntry[] Pubnames {
+			get { return pubnames; }
+		}
+
+		// <summary>
+		//   The symbol tables are only written out by the next SetDwarfIndex()
+		//   or Flush(), so we don't write the file twice while loading a module.
+		// </summary>
+		public void SetSymbols (NativeSymbolTable symbols)
+		{
+			lock (this) {
+				this.symbols = symbols;
+				dirty = true;
+			}
+		}
+
+		public void SetDwarfIndex (RangeEntry[] aranges, NameEntry[] pubnames)
+		{
+			lock (this) {
+				this.aranges = aranges;
+				this.pubnames = pubnames;
+				save ();
+			}
+		}
+
+		// <summary>
+		//   Write any data which hasn't been saved yet.
+		// </summary>
+		public void Flush ()
+		{
+			lock (this) {
+				if (dirty)
+					save ();
+			}
+		}
+
+		void clear ()
+		{
+			symbols = null;
+			aranges = null;
+			pubnames = null;
+		}
+
+		static string hash_file_name (string filename)
+		{
+			byte[] hash = MD5.Create ().ComputeHash (Encoding.UTF8.GetBytes (filename));
+			return to_hex (hash, 0, hash.Length);
+		}
+
+		static string to_hex (byte[] data, int offset, int length)
+		{
+			StringBuilder sb = new StringBuilder (length * 2);
+			for (int i = 0; i < length; i++)
+				sb.Append (data [offset + i].ToString ("x2"));
+			return sb.ToString ();
+		}
+
+		// <summary>
+		//   Extract the build-id from a .note.gnu.build-id section.
+		// </summary>
+		static string read_build_id (TargetBlob note)
+		{
+			if ((note == null) || (note.Size < 16))
+				return null;
+
+			TargetBinaryReader reader = new TargetBinaryReader (note);
+			int namesz = reader.ReadInt32 ();
+			int descsz = reader.ReadInt32 ();
+			int type = reader.ReadInt32 ();
+
+			// NT_GNU_BUILD_ID
+			if ((type != 3) || (namesz != 4) || (descsz <= 0))
+				return null;
+
+			reader.Position += 4;
+			if (reader.Position + descsz > reader.Size)
+				return null;
+
+			byte[] desc = reader.ReadBuffer (descsz);
+			return to_hex (desc, 0, descsz);
+		}
+
+		//
+		// File format (all integers in little-endian byte order):
+		//
+		//   header:     int magic, int version, string target, string build-id,
+		//               string filename, long size, long mtime
+		//   strings:    int count, { int length, byte[length] utf8 } (pubnames)
+		//   symbols:    int present, int count, long[count] addresses, int[count] names,
+		//               int[count] flags, int[count] name order, int size, byte[size]
+		//               strings; this is the NativeSymbolTable as-is
+		//   dwarf:      int present, int count, { long offset, long address, long size },
+		//               int count (-1 if there's no .debug_pubnames),
+		//               { int name, long file_offset, long offset }
+		//
+		// Strings are written as length + UTF-8 bytes since
+		// TargetBinaryReader.ReadString() doesn't decode UTF-8.
+		//
+
+		void read ()
+		{
+			byte[] contents;
+			using (FileStream stream = new FileStream (
+				       CacheFileName, FileMode.Open, FileAccess.Read)) {
+				contents = new BinaryReader (stream).ReadBytes ((int) stream.Length);
+			}
+
+			//
+			// BinaryWriter always writes little-endian, so don't use the target's
+			// byte order here.
+			//
+			TargetMemoryInfo file_info = new TargetMemoryInfo (
+				4, 8, 8, false, info.AddressDomain);
+			TargetBinaryReader reader = new TargetBinaryReader (
+				new TargetBlob (contents, file_info));
+
+			if ((reader.ReadInt32 () != Magic) || (reader.ReadInt32 () != Version))
+				throw new IOException ("Wrong magic or version");
+
+			string c_target = read_string (reader);
+			string c_build_id = read_string (reader);
+			string c_filename = read_string (reader);
+			long c_size = reader.ReadInt64 ();
+			long c_mtime = reader.ReadInt64 ();
+
+			bool valid = (c_target == target) && (c_size == size) &&
+				(c_build_id == build_id);
+			if (valid && (build_id == ""))
+				valid = (c_filename == FileName) && (c_mtime == mtime);
+
+			if (!valid) {
+				Report.Debug (DebugFlags.SymbolTable,
+					      "Symbol cache {0} for {1} is stale", CacheFileName, FileName);
+				return;
+			}
+
+			string[] strings = new string [reader.ReadInt32 ()];
+			for (int i = 0; i < strings.Length; i++)
+				strings [i] = read_string (reader);
+
+			if (reader.ReadInt32 () != 0)
+				symbols = read_symbols (reader);
+
+			if (reader.ReadInt32 () != 0) {
+				aranges = new RangeEntry [reader.ReadInt32 ()];
+				for (int i = 0; i < aranges.Length; i++) {
+					long offset = reader.ReadInt64 ();
+					long address = reader.ReadInt64 ();
+					long size = reader.ReadInt64 ();
+					aranges [i] = new RangeEntry (offset, address, size);
+				}
+
+				int count = reader.ReadInt32 ();
+				if (count >= 0) {
+					pubnames = new NameEntry [count];
+					for (int i = 0; i < count; i++) {
+						string name = strings [reader.ReadInt32 ()];
+						long file_offset = reader.ReadInt64 ();
+						long offset = reader.ReadInt64 ();
+						pubnames [i] = new NameEntry (name, file_offset, offset);
+					}
+				}
+			}
+
+			Report.Debug (DebugFlags.SymbolTable,
+				      "Read symbol cache {0} for {1}: {2} {3}", CacheFileName,
+				      FileName, HasSymbols, HasDwarfIndex);
+		}
+
+		static string read_string (TargetBinaryReader reader)
+		{
+			int length = reader.ReadInt32 ();
+			return Encoding.UTF8.GetString (reader.ReadBuffer (length));
+		}
+
+		static NativeSymbolTable read_symbols (TargetBinaryReader reader)
+		{
+			int count = reader.ReadInt32 ();
+
+			long[] addresses = new long [count];
+			if (BitConverter.IsLittleEndian)
+				Buffer.BlockCopy (reader.ReadBuffer (count * 8), 0, addresses, 0, count * 8);
+			else {
+				for (int i = 0; i < count; i++)
+					addresses [i] = reader.ReadInt64 ();
+			}
+
+			int[] names = read_int_array (reader, count);
+			int[] flags = read_int_array (reader, count);
+			int[] name_order = read_int_array (reader, count);
+			byte[] strings = reader.ReadBuffer (reader.ReadInt32 ());
+
+			return new NativeSymbolTable (addresses, names, flags, name_order, strings);
+		}
+
+		static int[] read_int_array (TargetBinaryReader reader, int count)
+		{
+			int[] array = new int [count];
+			if (BitConverter.IsLittleEndian)
+				Buffer.BlockCopy (reader.ReadBuffer (count * 4), 0, array, 0, count * 4);
+			else {
+				for (int i = 0; i < count; i++)
+					array [i] = reader.ReadInt32 ();
+			}
+			return array;
+		}
+
+		void save ()
+		{
+			dirty = false;
+
+			string temp_file = String.Format ("{0}.{1}.tmp", CacheFileName,
+							  System.Diagnostics.Process.GetCurrentProcess ().Id);
+
+			try {
+				string dir = Path.GetDirectoryName (CacheFileName);
+				if (!Directory.Exists (dir))
+					Directory.CreateDirectory (dir);
+
+				using (FileStream stream = new FileStream (temp_file, FileMode.Create))
+					write (new BinaryWriter (stream));
+
+				// Write to a temporary file and move it in place, so another
+				// debugger which is reading the same entry never sees a partial file.
+				if (File.Exists (CacheFileName))
+					File.Delete (CacheFileName);
+				File.Move (temp_file, CacheFileName);
+			} catch (Exception ex) {
+				Report.Debug (DebugFlags.SymbolTable,
+					      "Cannot write symbol cache {0}: {1}", CacheFileName, ex.Message);
+				try {
+					File.Delete (temp_file);
+				} catch {
+				}
+			}
+		}
+
+		void write (BinaryWriter writer)
+		{
+			ArrayList strings = new ArrayList ();
+			Hashtable string_hash = new Hashtable ();
+
+			writer.Write (Magic);
+			writer.Write (Version);
+			write_string (writer, target);
+			write_string (writer, build_id);
+			write_string (writer, FileName);
+			writer.Write (size);
+			writer.Write (mtime);
+
+			if (pubnames != null) {
+				foreach (NameEntry entry in pubnames)
+					add_string (strings, string_hash, entry.Name);
+			}
+
+			writer.Write (strings.Count);
+			foreach (string s in strings)
+				write_string (writer, s);
+
+			if (HasSymbols) {
+				writer.Write (1);
+				write_symbols (writer, symbols);
+			} else
+				writer.Write (0);
+
+			if (HasDwarfIndex) {
+				writer.Write (1);
+				writer.Write (aranges.Length);
+				foreach (RangeEntry entry in aranges) {
+					writer.Write (entry.FileOffset);
+					writer.Write (entry.Address);
+					writer.Write (entry.Size);
+				}
+
+				if (pubnames != null) {
+					writer.Write (pubnames.Length);
+					foreach (NameEntry entry in pubnames) {
+						writer.Write ((int) string_hash [entry.Name]);
+						writer.Write (entry.FileOffset);
+						writer.Write (entry.Offset);
+					}
+				} else
+					writer.Write (-1);
+			} else
+				writer.Write (0);
+
+			writer.Flush ();
+		}
+
+		static void write_string (BinaryWriter writer, string s)
+		{
+			byte[] bytes = Encoding.UTF8.GetBytes (s);
+			writer.Write (bytes.Length);
+			writer.Write (bytes);
+		}
+
+		static void add_string (ArrayList strings, Hashtable string_hash, string s)
+		{
+			if (string_hash.Contains (s))
+				return;
+
+			string_hash.Add (s, strings.Count);
+			strings.Add (s);
+		}
+
+		static void write_symbols (BinaryWriter writer, NativeSymbolTable symbols)
+		{
+			writer.Write (symbols.Count);
+			foreach (long address in symbols.Addresses)
+				writer.Write (address);
+			foreach (int name in symbols.Names)
+				writer.Write (name);
+			foreach (int flags in symbols.Flags)
+				writer.Write (flags);
+			foreach (int index in symbols.NameOrder)
+				writer.Write (index);
+			writer.Write (symbols.Strings.Length);
+			writer.Write (symbols.Strings);
+		}
+
+		public override string ToString ()
+		{
+			return String.Format ("SymbolCache ({0}:{1})", FileName, CacheFileName);
+		}
+	}
+}
@@ -17,6 +17,12 @@ namespace Mono.Debugger
 	// </summary>
 	public abstract class Breakpoint : Event
 	{
+		IBreakpointCondition condition;
+		int ignore_count;
+		int hit_count;
+		bool is_tracepoint;
+		TraceAction[] trace_actions = new TraceAction [0];
+
 		internal abstract BreakpointHandle Resolve (Thread target, StackFrame frame);
 
 		public override bool NeedsActivation {
@@ -59,6 +65,123 @@ namespace Mono.Debugger
 			return true;
 		}
 
+		// <summary>
+		//   An optional condition; the breakpoint only stops the target
+		//   if it evaluates to true.
+		// </summary>
+		public IBreakpointCondition Condition {
+			get { return condition; }
+			set { condition = value; }
+		}
+
+		// <summary>
+		//   The number of times this breakpoint is to be ignored; it is
+		//   decremented each time the breakpoint is hit and its condition
+		//   holds.
+		// </summary>
+		public int IgnoreCount {
+			get { return ignore_count; }
+			set {
+				if (value < 0)
+					throw new ArgumentOutOfRangeException ();
+				ignore_count = value;
+			}
+		}
+
+		// <summary>
+		//   The number of times this breakpoint was hit with its condition
+		//   being true, including the ignored hits.
+		// </summary>
+		public int HitCount {
+			get { return hit_count; }
+			set { hit_count = value; }
+		}
+
+		// <summary>
+		//   Called by the SingleSteppingEngine, on the engine thread, after
+		//   CheckBreakpointHit() returned true.  Evaluates the condition and
+		//   updates the hit and ignore counts; returns false to silently
+		//   resume the target.
+		// </summary>
+		internal bool CheckCondition (StackFrame frame)
+		{
+			IBreakpointCondition cond = condition;
+			if (cond != null) {
+				try {
+					if (!cond.Evaluate (frame))
+						return false;
+				} catch (Exception ex) {
+					OnBreakpointError ("Cannot evaluate condition `{0}': {1}",
+							   cond.Text, ex.Message);
+					hit_count++;
+					return true;
+				}
+			}
+
+			hit_count++;
+
+			if (ignore_count > 0) {
+				ignore_count--;
+				return false;
+			}
+
+			return true;
+		}
+
+		internal bool HasCondition {
+			get { return (condition != null) || (ignore_count > 0); }
+		}
+
+		internal void HandleHit ()
+		{
+			hit_count++;
+		}
+
+		// <summary>
+		//   A tracepoint never stops the target; each time it's hit, its
+		//   TraceActions are collected into the process'es TraceBuffer and
+		//   the target is resumed.
+		// </summary>
+		public bool IsTracepoint {
+			get { return is_tracepoint; }
+			set { is_tracepoint = value; }
+		}
+
+		public TraceAction[] TraceActions {
+			get { return trace_actions; }
+			set {
+				if (value == null)
+					throw new ArgumentNullException ();
+				trace_actions = value;
+			}
+		}
+
+		internal bool TraceNeedsFrame {
+			get {
+				foreach (TraceAction action in trace_actions) {
+					if (action.NeedsFrame)
+						return true;
+				}
+				return false;
+			}
+		}
+
+		internal override void GetBreakpointSessionData (XmlElement element)
+		{
+			if (condition != null)
+				element.SetAttribute ("condition", condition.Text);
+			if (ignore_count > 0)
+				element.SetAttribute ("ignore", ignore_count.ToString ());
+			if (hit_count > 0)
+				element.SetAttribute ("hits", hit_count.ToString ());
+			if (!is_tracepoint)
+				return;
+
+			element.SetAttribute ("trace", "true");
+			foreach (TraceAction action in trace_actions)
+				action.GetSessionData (element);
+		}
+
 		protected internal virtual void OnBreakpointBound ()
 		{ }
 
@@ -29,6 +29,8 @@ namespace Mono.Debugger
 			ConfigDirectory = Path.Combine (ConfigDirectory, "MonoDebugger");
 			ConfigDirectory += Path.DirectorySeparatorChar;
 
+			symbol_cache_directory = Path.Combine (ConfigDirectory, "SymbolCache");
+
 			module_groups = Hashtable.Synchronized (new Hashtable ());
 			directory_maps = new Dictionary<string,string> ();
 			CreateDefaultModuleGroups ();
@@ -122,6 +124,10 @@ namespace Mono.Debugger
 					NestedBreakStates = Boolean.Parse (iter.Current.Value);
 				else if (iter.Current.Name == "RedirectOutput")
 					RedirectOutput = Boolean.Parse (iter.Current.Value);
+				else if (iter.Current.Name == "SymbolCache")
+					SymbolCache = Boolean.Parse (iter.Current.Value);
+				else if (iter.Current.Name == "SymbolCacheDirectory")
+					SymbolCacheDirectory = iter.Current.Value;
 				else if (iter.Current.Name == "Martin_Boston_07102008") {
 					; // ignore, this is no longer in use.
 				} else if (iter.Current.Name == "BrokenThreading") {
@@ -219,6 +225,14 @@ namespace Mono.Debugger
 				redirect_output_e.InnerText = RedirectOutput ? "true" : "false";
 				element.AppendChild (redirect_output_e);
 
+				XmlElement symbol_cache_e = doc.CreateElement ("SymbolCache");
+				symbol_cache_e.InnerText = SymbolCache ? "true" : "false";
+				element.AppendChild (symbol_cache_e);
+
+				XmlElement symbol_cache_directory_e = doc.CreateElement ("SymbolCacheDirectory");
+				symbol_cache_directory_e.InnerText = SymbolCacheDirectory;
+				element.AppendChild (symbol_cache_directory_e);
+
 				XmlElement stop_daemon_threads_e = doc.CreateElement ("StopDaemonThreads");
 				stop_daemon_threads_e.InnerText = (ThreadingModel & ThreadingModel.StopDaemonThreads) != 0 ? "true" : "false";
 				element.AppendChild (stop_daemon_threads_e);
@@ -269,6 +283,8 @@ namespace Mono.Debugger
 		bool stop_on_managed_signals = true;
 		bool nested_break_states = false;
 		bool redirect_output = false;
+		bool symbol_cache = false;
+		string symbol_cache_directory;
 		bool is_xsp = false;
 		bool is_cli = false;
 		UserNotificationType user_notifications = UserNotificationType.Threads;
@@ -404,6 +420,21 @@ namespace Mono.Debugger
 			set { redirect_output = value; }
 		}
 
+		// <summary>
+		//   Keep an on-disk index of native symbol tables in
+		//   SymbolCacheDirectory, so we don't need to read them again on
+		//   the next start.
+		// </summary>
+		public bool SymbolCache {
+			get { return symbol_cache; }
+			set { symbol_cache = value; }
+		}
+
+		public string SymbolCacheDirectory {
+			get { return symbol_cache_directory; }
+			set { symbol_cache_directory = value; }
+		}
+
 		/*
 		 * Configurable user notifications.
 		 */
@@ -465,6 +496,8 @@ namespace Mono.Debugger
 
 			sb.Append (String.Format ("  Redirect output (redirect-output):                  {0}\n",
 						  RedirectOutput ? "yes" : "no"));
+			sb.Append (String.Format ("  Symbol cache (symbol-cache):                        {0}\n",
+						  SymbolCache ? SymbolCacheDirectory : "no"));
 
 			if (expert_mode) {
 				sb.Append ("\nExpert Settings:\n");
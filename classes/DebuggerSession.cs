@@ -36,6 +36,39 @@ namespace Mono.Debugger
 
 		SourceLocation ParseLocation (Thread target, StackFrame frame,
 					      LocationType type, string name);
+
+		IBreakpointCondition ParseCondition (string text);
+
+		ITraceExpression ParseTraceExpression (string text);
+	}
+
+	// <summary>
+	//   A breakpoint condition.  It's evaluated synchronously on the engine
+	//   thread each time the breakpoint is hit, so it must not invoke any
+	//   methods in the target.
+	// </summary>
+	public interface IBreakpointCondition
+	{
+		string Text {
+			get;
+		}
+
+		bool Evaluate (StackFrame frame);
+	}
+
+	// <summary>
+	//   An expression which is collected by a tracepoint.  Just like an
+	//   IBreakpointCondition, it's evaluated on the engine thread.
+	// </summary>
+	public interface ITraceExpression
+	{
+		string Text {
+			get;
+		}
+
+		string Evaluate (StackFrame frame);
+
+		TargetAddress EvaluateAddress (StackFrame frame);
 	}
 
 	[Serializable]
@@ -220,15 +253,33 @@ namespace Mono.Debugger
 		//
 
 		public Event InsertBreakpoint (ThreadGroup group, SourceLocation location)
+		{
+			return InsertBreakpoint (group, location, false);
+		}
+
+		// <summary>
+		//   The `is_tracepoint' overloads set Breakpoint.IsTracepoint before the
+		//   breakpoint is activated, so it never stops the target.
+		// </summary>
+		public Event InsertBreakpoint (ThreadGroup group, SourceLocation location,
+					       bool is_tracepoint)
 		{
 			Breakpoint bpt = new SourceBreakpoint (this, group, location);
+			bpt.IsTracepoint = is_tracepoint;
 			AddEvent (bpt);
 			return bpt;
 		}
 
 		public Event InsertBreakpoint (ThreadGroup group, LocationType type, string name)
+		{
+			return InsertBreakpoint (group, type, name, false);
+		}
+
+		public Event InsertBreakpoint (ThreadGroup group, LocationType type, string name,
+					       bool is_tracepoint)
 		{
 			Breakpoint bpt = new ExpressionBreakpoint (this, group, type, name);
+			bpt.IsTracepoint = is_tracepoint;
 			AddEvent (bpt);
 			return bpt;
 		}
@@ -236,10 +287,17 @@ namespace Mono.Debugger
 		public Event InsertBreakpoint (Thread target, ThreadGroup group,
 					       TargetAddress address)
 		{
-			Event handle = new AddressBreakpoint (address.ToString (), group, address);
-			handle.Activate (target);
-			AddEvent (handle);
-			return handle;
+			return InsertBreakpoint (target, group, address, false);
+		}
+
+		public Event InsertBreakpoint (Thread target, ThreadGroup group,
+					       TargetAddress address, bool is_tracepoint)
+		{
+			Breakpoint bpt = new AddressBreakpoint (address.ToString (), group, address);
+			bpt.IsTracepoint = is_tracepoint;
+			bpt.Activate (target);
+			AddEvent (bpt);
+			return bpt;
 		}
 
 		public Event InsertHardwareWatchPoint (Thread target, TargetAddress address,
@@ -422,14 +480,82 @@ namespace Mono.Debugger
 				if (!children.MoveNext ())
 					throw new InternalError ();
 				e = ParseEvent (children.Current, index, group);
-				if (children.MoveNext ())
-					throw new InternalError ();
 
 				e.IsEnabled = enabled;
+
+				Breakpoint bpt = e as Breakpoint;
+				if (bpt != null)
+					LoadBreakpointAttributes (event_iter.Current, children, bpt);
+				else if (children.MoveNext ())
+					throw new InternalError ();
+
 				AddEvent (e);
 			}
 		}
 
+		void LoadBreakpointAttributes (XPathNavigator nav, XPathNodeIterator children,
+					       Breakpoint bpt)
+		{
+			//
+			// Don't let a condition or trace expression which doesn't parse anymore
+			// abort loading the rest of the session; the breakpoint is loaded without it.
+			//
+			string condition = nav.GetAttribute ("condition", "");
+			if (condition != "") {
+				try {
+					bpt.Condition = parser.ParseCondition (condition);
+				} catch (Exception ex) {
+					Report.Error ("Cannot parse condition `{0}' of breakpoint {1}, " +
+						      "making it unconditional: {2}", condition, bpt.Index,
+						      ex.Message);
+				}
+			}
+
+			string ignore = nav.GetAttribute ("ignore", "");
+			if (ignore != "")
+				bpt.IgnoreCount = Int32.Parse (ignore);
+
+			string hits = nav.GetAttribute ("hits", "");
+			if (hits != "")
+				bpt.HitCount = Int32.Parse (hits);
+
+			string trace = nav.GetAttribute ("trace", "");
+			if (trace != "")
+				bpt.IsTracepoint = Boolean.Parse (trace);
+
+			List<TraceAction> actions = new List<TraceAction> ();
+			while (children.MoveNext ()) {
+				if (children.Current.Name != "TraceAction")
+					throw new InternalError ();
+
+				try {
+					actions.Add (ParseTraceAction (children.Current));
+				} catch (Exception ex) {
+					Report.Error ("Cannot parse trace action of tracepoint {0}: {1}",
+						      bpt.Index, ex.Message);
+				}
+			}
+			bpt.TraceActions = actions.ToArray ();
+		}
+
+		TraceAction ParseTraceAction (XPathNavigator nav)
+		{
+			TraceActionType type = (TraceActionType) Enum.Parse (
+				typeof (TraceActionType), nav.GetAttribute ("type", ""));
+
+			switch (type) {
+			case TraceActionType.Registers:
+				return new TraceAction ();
+			case TraceActionType.Memory:
+				return new TraceAction (
+					parser.ParseTraceExpression (nav.GetAttribute ("expression", "")),
+					Int32.Parse (nav.GetAttribute ("length", "")));
+			default:
+				return new TraceAction (
+					parser.ParseTraceExpression (nav.GetAttribute ("expression", "")));
+			}
+		}
+
 		protected void LoadDisplays (XPathNodeIterator display_iter)
 		{
 			while (display_iter.MoveNext ()) {
@@ -829,6 +955,11 @@ namespace Mono.Debugger
 			return true;
 		}
 
+		// <summary>
+		//   This is also called from the DwarfReader's thread pool workers.
+		//   It's safe because both directory maps are only modified while
+		//   the session and the configuration are being loaded.
+		// </summary>
 		public string MapFileName (string path)
 		{
 			path = DebuggerConfiguration.WindowsToUnix (path);
@@ -126,8 +126,12 @@ namespace Mono.Debugger
 			element.SetAttribute ("enabled", IsEnabled ? "true" : "false");
 
 			GetSessionData (root, element);
+			GetBreakpointSessionData (element);
 		}
 
+		internal virtual void GetBreakpointSessionData (XmlElement element)
+		{ }
+
 		protected abstract void GetSessionData (XmlElement root, XmlElement element);
 
 		//
@@ -28,7 +28,7 @@ namespace Mono.Debugger
 			this.func = func;
 			this.user_data = user_data;
 			this.initial_ttl = this.ttl = ttl;
-			this.id = ++next_id;
+			this.id = Interlocked.Increment (ref next_id);
 
 			mutex.Lock ();
 			objects.Add (this);
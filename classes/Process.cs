@@ -156,6 +156,7 @@ namespace Mono.Debugger
 		SymbolTableManager symtab_manager;
 		MonoThreadManager mono_manager;
 		BreakpointManager breakpoint_manager;
+		TraceBuffer trace_buffer;
 		Dictionary<int,ExceptionCatchPoint> exception_handlers;
 		ProcessStart start;
 		DebuggerSession session;
@@ -189,6 +190,8 @@ namespace Mono.Debugger
 
 			thread_hash = Hashtable.Synchronized (new Hashtable ());
 
+			trace_buffer = new TraceBuffer (TraceBuffer.DefaultSize);
+
 			target_info = Inferior.GetTargetInfo ();
 			if (target_info.TargetAddressSize == 8)
 				architecture = new Architecture_X86_64 (this, target_info);
@@ -269,6 +272,13 @@ namespace Mono.Debugger
 			get { return breakpoint_manager; }
 		}
 
+		// <summary>
+		//   The data collected by tracepoints.
+		// </summary>
+		public TraceBuffer TraceBuffer {
+			get { return trace_buffer; }
+		}
+
 		internal SymbolTableManager SymbolTableManager {
 			get {
 				return symtab_manager;
@@ -779,10 +789,25 @@ namespace Mono.Debugger
 			Report.Debug (DebugFlags.Threads,
 				      "Acquiring global thread lock: {0}", caller);
 			has_thread_lock = true;
+
+			List<SingleSteppingEngine> running = new List<SingleSteppingEngine> ();
 			foreach (ThreadServant thread in thread_hash.Values) {
 				if (thread == caller)
 					continue;
-				thread.AcquireThreadLock ();
+				SingleSteppingEngine engine = thread as SingleSteppingEngine;
+				if ((engine != null) && !engine.IsStopped)
+					running.Add (engine);
+				else
+					thread.AcquireThreadLock ();
+			}
+
+			if (running.Count > 0) {
+				SingleSteppingEngine[] engines = running.ToArray ();
+				bool[] stopped;
+				Inferior.ChildEvent[] stop_events;
+				SingleSteppingEngine.StopEngines (engines, out stopped, out stop_events);
+				for (int i = 0; i < engines.Length; i++)
+					engines [i].AcquireThreadLock (stopped [i], stop_events [i]);
 			}
 			Report.Debug (DebugFlags.Threads,
 				      "Done acquiring global thread lock: {0}",
@@ -862,6 +887,7 @@ namespace Mono.Debugger
 			Report.Debug (DebugFlags.Threads,
 				      "Suspending user threads: {0} {1}", model, caller);
 
+			List<SingleSteppingEngine> running = new List<SingleSteppingEngine> ();
 			foreach (SingleSteppingEngine engine in thread_hash.Values) {
 				Report.Debug (DebugFlags.Threads, "  check user thread: {0} {1}",
 					      engine, engine.Thread.ThreadFlags);
@@ -873,7 +899,19 @@ namespace Mono.Debugger
 				if (((engine.Thread.ThreadFlags & Thread.Flags.Daemon) != 0) &&
 				    ((model & ThreadingModel.StopDaemonThreads) == 0))
 					continue;
-				engine.SuspendUserThread ();
+				if (engine.IsStopped)
+					engine.SuspendUserThread ();
+				else
+					running.Add (engine);
+			}
+
+			if (running.Count > 0) {
+				SingleSteppingEngine[] engines = running.ToArray ();
+				bool[] stopped;
+				Inferior.ChildEvent[] stop_events;
+				SingleSteppingEngine.StopEngines (engines, out stopped, out stop_events);
+				for (int i = 0; i < engines.Length; i++)
+					engines [i].SuspendUserThread (stopped [i], stop_events [i]);
 			}
 
 			Report.Debug (DebugFlags.Threads,
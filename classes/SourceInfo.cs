@@ -1,6 +1,7 @@
 using System;
 using System.IO;
 using System.Text;
+using System.Threading;
 using System.Collections;
 using System.Runtime.InteropServices;
 
@@ -87,7 +88,8 @@ namespace Mono.Debugger
 
 		public SourceFile (DebuggerSession session, Module module, string name)
 		{
-			this.id = ++next_id;
+			// The DwarfReader creates source files on thread pool workers.
+			this.id = Interlocked.Increment (ref next_id);
 			this.module = module;
 
 			if ((name == "") || (name == null)) {
@@ -4,6 +4,8 @@ using System.Threading;
 using System.Collections;
 using System.Runtime.InteropServices;
 
+using Mono.Debugger.Backend;
+
 namespace Mono.Debugger
 {
 	public abstract class SymbolRangeEntry : ISymbolRange, IComparable
@@ -66,6 +68,9 @@ namespace Mono.Debugger
 		protected readonly TargetAddress end_address;
 
 		ObjectCache method_table;
+		ArrayList loaded_methods_source;
+		Method[] loaded_methods;
+		SymbolRangeIndex<ISymbolRange> range_index;
 
 		protected SymbolTable (TargetAddress start_address, TargetAddress end_address)
 		{
@@ -169,37 +174,126 @@ namespace Mono.Debugger
 				return null;
 
 			if (HasRanges) {
-				if (SymbolRanges == null)
+				SymbolRangeIndex<ISymbolRange> index = ensure_range_index ();
+				if (index == null)
 					return null;
 
-				foreach (SymbolRangeEntry range in SymbolRanges) {
-					if ((address < range.StartAddress) || (address >= range.EndAddress))
-						continue;
-
-					return range.SymbolLookup.Lookup (address);
-				}
+				ISymbolRange range = index.Lookup (address);
+				if (range == null)
+					return null;
 
-				return null;
+				return range.SymbolLookup.Lookup (address);
 			}
 
 			if (!HasMethods)
 				return null;
 
-			ArrayList methods = ensure_methods ();
+			Method[] methods = ensure_loaded_methods ();
 			if (methods == null)
 				return null;
 
-			foreach (Method method in methods) {
-				if (!method.IsLoaded)
-					continue;
+			//
+			// Find the last loaded method which starts at or before `address'.
+			//
+			int lo = 0, hi = methods.Length;
+			while (lo < hi) {
+				int mid = (lo + hi) / 2;
+				if (methods [mid].StartAddress <= address)
+					lo = mid + 1;
+				else
+					hi = mid;
+			}
+
+			if (lo == 0)
+				return null;
+
+			Method found = methods [lo - 1];
+			if (address >= found.EndAddress)
+				return null;
+
+			return found;
+		}
+
+		// <summary>
+		//   The loaded methods, sorted by start address.  Methods may be
+		//   loaded at any time, so this is rebuilt after UpdateSymbolTable().
+		// </summary>
+		Method[] ensure_loaded_methods ()
+		{
+			lock (this) {
+				ArrayList methods = ensure_methods ();
+				if (methods == null)
+					return null;
+
+				if ((loaded_methods != null) && (loaded_methods_source == methods))
+					return loaded_methods;
+
+				ArrayList loaded = new ArrayList ();
+				foreach (Method method in methods) {
+					if (method.IsLoaded)
+						loaded.Add (method);
+				}
+
+				loaded.Sort ();
+				loaded_methods = (Method []) loaded.ToArray (typeof (Method));
+				loaded_methods_source = methods;
+				return loaded_methods;
+			}
+		}
+
+		SymbolRangeIndex<ISymbolRange> ensure_range_index ()
+		{
+			lock (this) {
+				if (range_index != null)
+					return range_index;
 
-				if ((address < method.StartAddress) || (address >= method.EndAddress))
-					continue;
+				ISymbolRange[] ranges = SymbolRanges;
+				if (ranges == null)
+					return null;
+
+				range_index = new SymbolRangeIndex<ISymbolRange> ();
+				foreach (ISymbolRange range in ranges)
+					range_index.Add (range.StartAddress, range.EndAddress, range);
+				return range_index;
+			}
+		}
+
+		// <summary>
+		//   Subclasses which add to their SymbolRanges after they've been
+		//   created must call this for each new range, so Lookup() can find it.
+		// </summary>
+		protected void AddSymbolRange (ISymbolRange range)
+		{
+			lock (this) {
+				if (range_index != null)
+					range_index.Add (range.StartAddress, range.EndAddress, range);
+			}
+		}
 
-				return method;
+		// <summary>
+		//   Find the range containing `address' in a list of non-overlapping
+		//   SymbolRangeEntries which is sorted by start address.
+		// </summary>
+		protected static SymbolRangeEntry LookupRange (IList ranges, TargetAddress address)
+		{
+			int lo = 0, hi = ranges.Count;
+			while (lo < hi) {
+				int mid = (lo + hi) / 2;
+				SymbolRangeEntry range = (SymbolRangeEntry) ranges [mid];
+				if (range.StartAddress <= address)
+					lo = mid + 1;
+				else
+					hi = mid;
 			}
 
-			return null;
+			if (lo == 0)
+				return null;
+
+			SymbolRangeEntry found = (SymbolRangeEntry) ranges [lo - 1];
+			if (address >= found.EndAddress)
+				return null;
+
+			return found;
 		}
 
 		public virtual Symbol SimpleLookup (TargetAddress address, bool exact_match)
@@ -229,6 +323,11 @@ namespace Mono.Debugger
 
 		public virtual void UpdateSymbolTable ()
 		{
+			lock (this) {
+				loaded_methods = null;
+				loaded_methods_source = null;
+			}
+
 			if (SymbolTableChanged != null)
 				SymbolTableChanged ();
 		}
@@ -1,28 +1,123 @@
 using System;
 using System.Text;
+using System.Runtime.InteropServices;
+using System.Runtime.Serialization;
 
 namespace Mono.Debugger
 {
 	[Serializable]
 	public sealed class TargetBlob
 	{
-		public readonly byte[] Contents;
 		public readonly TargetMemoryInfo TargetMemoryInfo;
 
+		readonly byte[] buffer;
+		readonly int offset;
+		readonly int size;
+		byte[] contents;
+
+		//
+		// Blobs may also point into memory which doesn't belong to the GC heap,
+		// like a memory-mapped file.  `owner' is whatever keeps that memory
+		// alive.  When serialized, such a blob is converted into a normal one.
+		//
+		[NonSerialized] readonly object owner;
+		[NonSerialized] readonly IntPtr mapped;
+
 		public TargetBlob (byte[] contents, TargetMemoryInfo target_info)
 		{
-			this.Contents = contents;
+			this.buffer = this.contents = contents;
+			this.size = contents.Length;
 			this.TargetMemoryInfo = target_info;
 		}
 
 		public TargetBlob (int size, TargetMemoryInfo target_info)
+			: this (new byte [size], target_info)
+		{ }
+
+		internal TargetBlob (object owner, IntPtr mapped, int size, TargetMemoryInfo target_info)
 		{
-			this.Contents = new byte [size];
+			this.owner = owner;
+			this.mapped = mapped;
+			this.size = size;
 			this.TargetMemoryInfo = target_info;
 		}
 
+		TargetBlob (TargetBlob parent, int offset, int size)
+		{
+			this.buffer = parent.buffer;
+			this.owner = parent.owner;
+			this.mapped = parent.mapped;
+			this.offset = parent.offset + offset;
+			this.size = size;
+			this.TargetMemoryInfo = parent.TargetMemoryInfo;
+			if ((buffer != null) && (this.offset == 0) && (size == buffer.Length))
+				this.contents = buffer;
+		}
+
+		// <summary>
+		//   The contents of this blob.  For a slice which doesn't cover its
+		//   whole underlying buffer or a mapped blob, this creates a copy on
+		//   first access.
+		// </summary>
+		public byte[] Contents {
+			get {
+				if (contents == null) {
+					contents = new byte [size];
+					if (buffer != null)
+						System.Buffer.BlockCopy (buffer, offset, contents, 0, size);
+					else
+						Marshal.Copy ((IntPtr) ((long) mapped + offset), contents, 0, size);
+				}
+				return contents;
+			}
+		}
+
+		[OnSerializing]
+		void on_serializing (StreamingContext context)
+		{
+			if (buffer == null)
+				contents = Contents;
+		}
+
 		public int Size {
-			get { return Contents.Length; }
+			get { return size; }
+		}
+
+		//
+		// The underlying storage - either `Buffer' or `Mapped' is set.  After
+		// deserializing a mapped blob, only `contents' is left.
+		//
+
+		internal byte[] Buffer {
+			get {
+				if ((buffer == null) && (mapped == IntPtr.Zero))
+					return contents;
+				return buffer;
+			}
+		}
+
+		internal IntPtr Mapped {
+			get { return mapped; }
+		}
+
+		internal int Offset {
+			get {
+				if ((buffer == null) && (mapped == IntPtr.Zero))
+					return 0;
+				return offset;
+			}
+		}
+
+		// <summary>
+		//   Returns a view of `size' bytes at `offset' in this blob which shares
+		//   its storage; reading it through GetReader() doesn't copy anything.
+		// </summary>
+		public TargetBlob GetSlice (int offset, int size)
+		{
+			if ((offset < 0) || (size < 0) || (offset + size > this.size))
+				throw new ArgumentOutOfRangeException ();
+
+			return new TargetBlob (this, offset, size);
 		}
 
 		public TargetBinaryReader GetReader ()
@@ -38,9 +133,17 @@ namespace Mono.Debugger
 		protected int pos;
 		protected bool swap;
 
+		// The blob's underlying storage and the start of the blob in it.
+		protected readonly byte[] data;
+		[NonSerialized] protected readonly IntPtr mapped;
+		protected readonly int start;
+
 		public TargetBinaryAccess (TargetBlob blob)
 		{
 			this.blob = blob;
+			this.data = blob.Buffer;
+			this.mapped = blob.Mapped;
+			this.start = blob.Offset;
 			this.swap = blob.TargetMemoryInfo.IsBigEndian;
 		}
 
@@ -63,7 +166,7 @@ namespace Mono.Debugger
 
 		public long Size {
 			get {
-				return blob.Contents.Length;
+				return blob.Size;
 			}
 		}
 
@@ -79,7 +182,7 @@ namespace Mono.Debugger
 
 		public bool IsEof {
 			get {
-				return pos == blob.Contents.Length;
+				return pos == blob.Size;
 			}
 		}
 
@@ -1,4 +1,5 @@
 using System;
+using System.Runtime.InteropServices;
 
 namespace Mono.Debugger
 {
@@ -17,39 +18,81 @@ namespace Mono.Debugger
 		{
 		}
 
+		//
+		// A blob may be a slice of a larger buffer or mapping, so neither the
+		// runtime's array bounds check nor the mapping's size protects us from
+		// reading past the end of the slice.
+		//
+		void check_bounds (long offset, int size)
+		{
+			if ((offset < 0) || (offset + size > blob.Size))
+				throw new TargetMemoryException (String.Format (
+					"Read beyond end of blob: {0}+{1}", offset, size));
+		}
+
+		//
+		// The wide accessors only check the bounds once and then read the
+		// whole value at once if the target has the host's byte order;
+		// raw_byte() doesn't do any checking.
+		//
+		bool native_order {
+			get { return swap != BitConverter.IsLittleEndian; }
+		}
+
+		byte raw_byte (long offset)
+		{
+			if (data != null)
+				return data[start+offset];
+
+			return Marshal.ReadByte (mapped, (int) (start + offset));
+		}
+
+		byte get_byte (long offset)
+		{
+			check_bounds (offset, 1);
+			return raw_byte (offset);
+		}
+
 		public byte PeekByte (long pos)
 		{
-			return blob.Contents[pos];
+			return get_byte (pos);
 		}
 
 		public byte PeekByte ()
 		{
-			return blob.Contents[pos];
+			return get_byte (pos);
 		}
 
 		public byte ReadByte ()
 		{
-			return blob.Contents[pos++];
+			return get_byte (pos++);
 		}
 
 		public sbyte PeekSByte ()
 		{
-			return (sbyte) blob.Contents[pos];
+			return (sbyte) get_byte (pos);
 		}
 
 		public sbyte ReadSByte ()
 		{
-			return (sbyte) blob.Contents[pos++];
+			return (sbyte) get_byte (pos++);
 		}
 
 		public short PeekInt16 (long pos)
 		{
-			if (swap)
-				return ((short) (blob.Contents[pos+1] |
-						 (blob.Contents[pos] << 8)));
+			check_bounds (pos, 2);
+
+			if (native_order) {
+				if (data != null)
+					return BitConverter.ToInt16 (data, (int) (start + pos));
+				else
+					return Marshal.ReadInt16 (mapped, (int) (start + pos));
+			} else if (swap)
+				return ((short) (raw_byte (pos+1) |
+						 (raw_byte (pos) << 8)));
 			else
-				return ((short) (blob.Contents[pos] |
-						 (blob.Contents[pos+1] << 8)));
+				return ((short) (raw_byte (pos) |
+						 (raw_byte (pos+1) << 8)));
 		}
 
 		public short PeekInt16 ()
@@ -66,16 +109,23 @@ namespace Mono.Debugger
 
 		public int PeekInt32 (long pos)
 		{
-			if (swap)
-				return (blob.Contents[pos+3] |
-					(blob.Contents[pos+2] << 8) |
-					(blob.Contents[pos+1] << 16) |
-					(blob.Contents[pos] << 24));
+			check_bounds (pos, 4);
+
+			if (native_order) {
+				if (data != null)
+					return BitConverter.ToInt32 (data, (int) (start + pos));
+				else
+					return Marshal.ReadInt32 (mapped, (int) (start + pos));
+			} else if (swap)
+				return (raw_byte (pos+3) |
+					(raw_byte (pos+2) << 8) |
+					(raw_byte (pos+1) << 16) |
+					(raw_byte (pos) << 24));
 			else
-				return (blob.Contents[pos] |
-					(blob.Contents[pos+1] << 8) |
-					(blob.Contents[pos+2] << 16) |
-					(blob.Contents[pos+3] << 24));
+				return (raw_byte (pos) |
+					(raw_byte (pos+1) << 8) |
+					(raw_byte (pos+2) << 16) |
+					(raw_byte (pos+3) << 24));
 		}
 
 		public int PeekInt32 ()
@@ -92,16 +142,7 @@ namespace Mono.Debugger
 
 		public uint PeekUInt32 (long pos)
 		{
-			if (swap)
-				return ((uint) blob.Contents[pos+3] |
-					((uint) blob.Contents[pos+2] << 8) |
-					((uint) blob.Contents[pos+1] << 16) |
-					((uint) blob.Contents[pos] << 24));
-			else
-				return ((uint) blob.Contents[pos] |
-					((uint) blob.Contents[pos+1] << 8) |
-					((uint) blob.Contents[pos+2] << 16) |
-					((uint) blob.Contents[pos+3] << 24));
+			return (uint) PeekInt32 (pos);
 		}
 
 		public uint PeekUInt32 ()
@@ -118,25 +159,34 @@ namespace Mono.Debugger
 
 		public long PeekInt64 (long pos)
 		{
+			check_bounds (pos, 8);
+
+			if (native_order) {
+				if (data != null)
+					return BitConverter.ToInt64 (data, (int) (start + pos));
+				else
+					return Marshal.ReadInt64 (mapped, (int) (start + pos));
+			}
+
 			uint ret_low, ret_high;
 			if (swap) {
-				ret_low  = (uint) (blob.Contents[pos+7]           |
-						   (blob.Contents[pos+6] << 8)  |
-						   (blob.Contents[pos+5] << 16) |
-						   (blob.Contents[pos+4] << 24));
-				ret_high = (uint) (blob.Contents[pos+3]         |
-						   (blob.Contents[pos+2] << 8)  |
-						   (blob.Contents[pos+1] << 16) |
-						   (blob.Contents[pos] << 24));
+				ret_low  = (uint) (raw_byte (pos+7)           |
+						   (raw_byte (pos+6) << 8)  |
+						   (raw_byte (pos+5) << 16) |
+						   (raw_byte (pos+4) << 24));
+				ret_high = (uint) (raw_byte (pos+3)         |
+						   (raw_byte (pos+2) << 8)  |
+						   (raw_byte (pos+1) << 16) |
+						   (raw_byte (pos) << 24));
 			} else {
-				ret_low  = (uint) (blob.Contents[pos]           |
-						   (blob.Contents[pos+1] << 8)  |
-						   (blob.Contents[pos+2] << 16) |
-						   (blob.Contents[pos+3] << 24));
-				ret_high = (uint) (blob.Contents[pos+4]         |
-						   (blob.Contents[pos+5] << 8)  |
-						   (blob.Contents[pos+6] << 16) |
-						   (blob.Contents[pos+7] << 24));
+				ret_low  = (uint) (raw_byte (pos)           |
+						   (raw_byte (pos+1) << 8)  |
+						   (raw_byte (pos+2) << 16) |
+						   (raw_byte (pos+3) << 24));
+				ret_high = (uint) (raw_byte (pos+4)         |
+						   (raw_byte (pos+5) << 8)  |
+						   (raw_byte (pos+6) << 16) |
+						   (raw_byte (pos+7) << 24));
 			}
 			return (long) ((((ulong) ret_high) << 32) | ret_low);
 		}
@@ -182,12 +232,12 @@ namespace Mono.Debugger
 		public string PeekString (long pos)
 		{
 			int length = 0;
-			while (blob.Contents[pos+length] != 0)
+			while (get_byte (pos+length) != 0)
 				length++;
 
 			char[] retval = new char [length];
 			for (int i = 0; i < length; i++)
-				retval [i] = (char) blob.Contents[pos+i];
+				retval [i] = (char) get_byte (pos+i);
 
 			return new String (retval);
 		}
@@ -204,11 +254,20 @@ namespace Mono.Debugger
 			return retval;
 		}
 
+		void copy_to (long offset, byte[] buffer, int size)
+		{
+			check_bounds (offset, size);
+			if (data != null)
+				Array.Copy (data, start + offset, buffer, 0, size);
+			else
+				Marshal.Copy ((IntPtr) ((long) mapped + start + offset), buffer, 0, size);
+		}
+
 		public byte[] PeekBuffer (long offset, int size)
 		{
 			byte[] buffer = new byte [size];
 
-			Array.Copy (blob.Contents, (int) offset, buffer, 0, size);
+			copy_to (offset, buffer, size);
 
 			return buffer;
 		}
@@ -222,7 +281,7 @@ namespace Mono.Debugger
 		{
 			byte[] buffer = new byte [size];
 
-			Array.Copy (blob.Contents, pos, buffer, 0, size);
+			copy_to (pos, buffer, size);
 			pos += size;
 
 			return buffer;
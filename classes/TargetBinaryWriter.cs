@@ -9,25 +9,53 @@ namespace Mono.Debugger
 			: base (new TargetBlob (size, target_info))
 		{ }
 
+		// <summary>
+		//   Writes into @blob's underlying buffer, so the data is also seen by
+		//   all other views of it.  Mapped blobs are read-only.
+		// </summary>
+		public TargetBinaryWriter (TargetBlob blob)
+			: base (blob)
+		{
+			if (data == null)
+				throw new ArgumentException ("Cannot write to a mapped blob.");
+		}
+
+		//
+		// We always write to the shared buffer and not to `blob.Contents',
+		// which is a private copy for a slice.
+		//
+		void check_bounds (long offset, int size)
+		{
+			if ((offset < 0) || (offset + size > blob.Size))
+				throw new TargetMemoryException (String.Format (
+					"Write beyond end of blob: {0}+{1}", offset, size));
+		}
+
+		void put_byte (long offset, byte value)
+		{
+			check_bounds (offset, 1);
+			data[start+offset] = value;
+		}
+
 		public void PokeByte (long pos, byte value)
 		{
-			blob.Contents[pos] = value;
+			put_byte (pos, value);
 		}
 
 		public void PokeByte (byte value)
 		{
-			blob.Contents[pos] = value;
+			put_byte (pos, value);
 		}
 
 		public void WriteByte (byte value)
 		{
-			blob.Contents[pos++] = value;
+			put_byte (pos++, value);
 		}
 
 		public void PokeInt16 (long pos, short value)
 		{
-			blob.Contents[pos] = (byte) (value & 0x00ff);
-			blob.Contents[pos+1] = (byte) (value >> 8);
+			put_byte (pos, (byte) (value & 0x00ff));
+			put_byte (pos+1, (byte) (value >> 8));
 		}
 
 		public void PokeInt16 (short value)
@@ -43,10 +71,10 @@ namespace Mono.Debugger
 
 		public void PokeInt32 (long pos, int value)
 		{
-			blob.Contents[pos] = (byte) (value & 0x000000ff);
-			blob.Contents[pos+1] = (byte) ((value & 0x0000ff00) >> 8);
-			blob.Contents[pos+2] = (byte) ((value & 0x00ff0000) >> 16);
-			blob.Contents[pos+3] = (byte) ((value & 0xff000000) >> 24);
+			put_byte (pos, (byte) (value & 0x000000ff));
+			put_byte (pos+1, (byte) ((value & 0x0000ff00) >> 8));
+			put_byte (pos+2, (byte) ((value & 0x00ff0000) >> 16));
+			put_byte (pos+3, (byte) ((value & 0xff000000) >> 24));
 		}
 
 		public void PokeInt32 (int value)
@@ -118,12 +146,13 @@ namespace Mono.Debugger
 
 		public void PokeBuffer (long pos, byte[] buffer)
 		{
-			Array.Copy (buffer, 0, blob.Contents, (int) pos, buffer.Length);
+			check_bounds (pos, buffer.Length);
+			Array.Copy (buffer, 0, data, start + (int) pos, buffer.Length);
 		}
 
 		public void WriteBuffer (byte[] buffer)
 		{
-			Array.Copy (buffer, 0, blob.Contents, pos, buffer.Length);
+			PokeBuffer (pos, buffer);
 			pos += buffer.Length;
 		}
 	}
@@ -0,0 +1,509 @@
+using System;
+using System.IO;
+using System.Text;
+using System.Diagnostics;
+using System.Collections.Generic;
+using System.Xml;
+
+using Mono.Debugger.Backend;
+
+namespace Mono.Debugger
+{
+	public enum TraceActionType
+	{
+		Registers,
+		Memory,
+		Expression
+	}
+
+	// <summary>
+	//   Something a tracepoint collects each time it's hit.
+	// </summary>
+	public sealed class TraceAction
+	{
+		public readonly TraceActionType Type;
+		public readonly ITraceExpression Expression;
+		public readonly int Length;
+
+		public TraceAction ()
+			: this (TraceActionType.Registers, null, 0)
+		{ }
+
+		public TraceAction (ITraceExpression expression)
+			: this (TraceActionType.Expression, expression, 0)
+		{ }
+
+		public TraceAction (ITraceExpression address, int length)
+			: this (TraceActionType.Memory, address, length)
+		{
+			if (length <= 0)
+				throw new ArgumentOutOfRangeException ("length");
+		}
+
+		TraceAction (TraceActionType type, ITraceExpression expression, int length)
+		{
+			this.Type = type;
+			this.Expression = expression;
+			this.Length = length;
+		}
+
+		internal bool NeedsFrame {
+			get { return Type != TraceActionType.Registers; }
+		}
+
+		internal void GetSessionData (XmlElement root)
+		{
+			XmlElement element = root.OwnerDocument.CreateElement ("TraceAction");
+			root.AppendChild (element);
+
+			element.SetAttribute ("type", Type.ToString ());
+			if (Expression != null)
+				element.SetAttribute ("expression", Expression.Text);
+			if (Type == TraceActionType.Memory)
+				element.SetAttribute ("length", Length.ToString ());
+		}
+
+		public override string ToString ()
+		{
+			switch (Type) {
+			case TraceActionType.Registers:
+				return "$regs";
+			case TraceActionType.Memory:
+				return String.Format ("$mem {0} {1}", Expression.Text, Length);
+			default:
+				return Expression.Text;
+			}
+		}
+	}
+
+	// <summary>
+	//   One hit of a tracepoint, as read back from a TraceBuffer or a dump file.
+	// </summary>
+	public sealed class TraceFrame
+	{
+		public readonly long Number;
+		public readonly int Tracepoint;
+		public readonly int ThreadID;
+		public readonly DateTime Time;
+		public readonly long Address;
+
+		public readonly KeyValuePair<string,long>[] Registers;
+		public readonly KeyValuePair<long,byte[]>[] Memory;
+		public readonly KeyValuePair<string,string>[] Values;
+
+		internal TraceFrame (long number, byte[] data, string[] register_names)
+		{
+			this.Number = number;
+
+			List<KeyValuePair<string,long>> registers = new List<KeyValuePair<string,long>> ();
+			List<KeyValuePair<long,byte[]>> memory = new List<KeyValuePair<long,byte[]>> ();
+			List<KeyValuePair<string,string>> values = new List<KeyValuePair<string,string>> ();
+
+			BinaryReader reader = new BinaryReader (new MemoryStream (data));
+			Tracepoint = reader.ReadInt32 ();
+			ThreadID = reader.ReadInt32 ();
+			Time = new DateTime (reader.ReadInt64 ());
+			Address = reader.ReadInt64 ();
+
+			while (reader.BaseStream.Position < data.Length) {
+				char type = (char) reader.ReadByte ();
+				switch (type) {
+				case 'R': {
+					int count = reader.ReadInt16 ();
+					for (int i = 0; i < count; i++) {
+						int index = reader.ReadInt16 ();
+						long value = reader.ReadInt64 ();
+						string name = index < register_names.Length ?
+							register_names [index] : "%" + index;
+						registers.Add (new KeyValuePair<string,long> (name, value));
+					}
+					break;
+				}
+
+				case 'M': {
+					long address = reader.ReadInt64 ();
+					int length = reader.ReadInt32 ();
+					memory.Add (new KeyValuePair<long,byte[]> (
+							    address, reader.ReadBytes (length)));
+					break;
+				}
+
+				case 'V':
+				case 'E': {
+					string name = reader.ReadString ();
+					string value = reader.ReadString ();
+					if (type == 'E')
+						value = "<" + value + ">";
+					values.Add (new KeyValuePair<string,string> (name, value));
+					break;
+				}
+
+				default:
+					throw new InvalidDataException (String.Format (
+						"Unknown block type `{0}' in trace frame {1}.",
+						type, number));
+				}
+			}
+
+			Registers = registers.ToArray ();
+			Memory = memory.ToArray ();
+			Values = values.ToArray ();
+		}
+	}
+
+	// <summary>
+	//   A fixed-size ring buffer holding the data collected by tracepoints.
+	//
+	//   Tracepoints are collected by the SingleSteppingEngine, on the engine
+	//   thread, each time one is hit; the target is resumed immediately
+	//   afterwards without sending any events to the clients.  When the
+	//   buffer is full, the oldest frames are dropped.
+	//
+	//   Each frame is stored as its length followed by a header (tracepoint
+	//   index, thread, time and address) and one block per action:
+	//
+	//     'R' count (index value)*          registers
+	//     'M' address length data           a memory range
+	//     'V' expression value              a formatted expression
+	//     'E' action message                an action which failed
+	//
+	//   Save() writes the buffer in the same format, preceded by a small header
+	//   with the register names; Load() reads it back.
+	// </summary>
+	public sealed class TraceBuffer : DebuggerMarshalByRefObject
+	{
+		public const int DefaultSize = 1 << 20;
+
+		const string Magic = "MDBTRACE";
+		const int Version = 1;
+
+		byte[] buffer;
+		int start, used;
+		int count;
+		long first_frame;
+
+		long collected, dropped, errors;
+		long total_ticks, max_ticks, overhead_count;
+
+		string[] register_names = new string [0];
+
+		MemoryStream scratch;
+		BinaryWriter writer;
+
+		public TraceBuffer (int size)
+		{
+			if (size < 64)
+				throw new ArgumentOutOfRangeException ("size");
+
+			buffer = new byte [size];
+			scratch = new MemoryStream ();
+			writer = new BinaryWriter (scratch);
+		}
+
+		public int Size {
+			get { return buffer.Length; }
+		}
+
+		public int Used {
+			get { return used; }
+		}
+
+		public int Count {
+			get { return count; }
+		}
+
+		// <summary>
+		//   Number of frames collected since the last Clear(), including the
+		//   dropped ones.
+		// </summary>
+		public long Collected {
+			get { return collected; }
+		}
+
+		public long Dropped {
+			get { return dropped; }
+		}
+
+		// <summary>
+		//   Number of actions which could not be collected.
+		// </summary>
+		public long Errors {
+			get { return errors; }
+		}
+
+		// <summary>
+		//   Average time the engine spent on each hit, from the moment it got
+		//   the event from the wait thread until it resumed the thread (or
+		//   started stepping over the tracepoint).  The time the target needs
+		//   to stop and to report the event is not included.
+		// </summary>
+		public TimeSpan AverageOverhead {
+			get {
+				lock (this) {
+					if (overhead_count == 0)
+						return TimeSpan.Zero;
+					return ticks_to_timespan (total_ticks / overhead_count);
+				}
+			}
+		}
+
+		public TimeSpan MaximumOverhead {
+			get {
+				lock (this) {
+					return ticks_to_timespan (max_ticks);
+				}
+			}
+		}
+
+		static TimeSpan ticks_to_timespan (long ticks)
+		{
+			return TimeSpan.FromTicks (ticks * TimeSpan.TicksPerSecond / Stopwatch.Frequency);
+		}
+
+		public void Clear ()
+		{
+			lock (this) {
+				first_frame += count;
+				start = used = count = 0;
+				collected = dropped = errors = 0;
+				total_ticks = max_ticks = overhead_count = 0;
+			}
+		}
+
+		// <summary>
+		//   Called by the SingleSteppingEngine when tracepoint @bpt has been hit.
+		//   @frame may only be null if none of its actions need it.
+		// </summary>
+		internal void Collect (Breakpoint bpt, Thread thread, Inferior inferior,
+				       TargetAddress address, StackFrame frame)
+		{
+			lock (this) {
+				scratch.SetLength (0);
+
+				writer.Write (bpt.Index);
+				writer.Write (thread.ID);
+				writer.Write (DateTime.Now.Ticks);
+				writer.Write (address.Address);
+
+				foreach (TraceAction action in bpt.TraceActions) {
+					try {
+						collect (action, inferior, frame);
+					} catch (Exception ex) {
+						writer.Write ((byte) 'E');
+						writer.Write (action.ToString ());
+						writer.Write (ex.Message);
+						errors++;
+					}
+				}
+
+				writer.Flush ();
+				append (scratch.GetBuffer (), (int) scratch.Length);
+			}
+		}
+
+		// <summary>
+		//   Called by the SingleSteppingEngine once it resumed the thread after
+		//   a Collect(); @ticks are Stopwatch ticks.
+		// </summary>
+		internal void AddOverhead (long ticks)
+		{
+			lock (this) {
+				total_ticks += ticks;
+				overhead_count++;
+				if (ticks > max_ticks)
+					max_ticks = ticks;
+			}
+		}
+
+		// Everything is read before we write anything, so a failing action
+		// doesn't leave a partial block behind.
+		void collect (TraceAction action, Inferior inferior, StackFrame frame)
+		{
+			switch (action.Type) {
+			case TraceActionType.Registers: {
+				Registers regs = inferior.GetRegisters ();
+				if (register_names.Length == 0)
+					register_names = inferior.Architecture.RegisterNames;
+
+				List<Register> important = new List<Register> ();
+				foreach (Register reg in regs.ImportantRegisters) {
+					if ((reg != null) && reg.Valid)
+						important.Add (reg);
+				}
+
+				writer.Write ((byte) 'R');
+				writer.Write ((short) important.Count);
+				foreach (Register reg in important) {
+					writer.Write ((short) reg.Index);
+					writer.Write (reg.Value);
+				}
+				break;
+			}
+
+			case TraceActionType.Memory: {
+				TargetAddress addr = action.Expression.EvaluateAddress (frame);
+				byte[] data = inferior.ReadBuffer (addr, action.Length);
+				writer.Write ((byte) 'M');
+				writer.Write (addr.Address);
+				writer.Write (data.Length);
+				writer.Write (data);
+				break;
+			}
+
+			case TraceActionType.Expression: {
+				string value = action.Expression.Evaluate (frame);
+				writer.Write ((byte) 'V');
+				writer.Write (action.Expression.Text);
+				writer.Write (value);
+				break;
+			}
+			}
+		}
+
+		void append (byte[] data, int length)
+		{
+			collected++;
+
+			int needed = length + 4;
+			if (needed > buffer.Length) {
+				dropped++;
+				return;
+			}
+
+			while (used + needed > buffer.Length) {
+				int old_length = read_int32 (start);
+				start = (start + old_length + 4) % buffer.Length;
+				used -= old_length + 4;
+				count--;
+				first_frame++;
+				dropped++;
+			}
+
+			int pos = (start + used) % buffer.Length;
+			write_int32 (pos, length);
+			copy_in ((pos + 4) % buffer.Length, data, length);
+
+			used += needed;
+			count++;
+		}
+
+		void copy_in (int pos, byte[] data, int length)
+		{
+			int first = Math.Min (length, buffer.Length - pos);
+			System.Buffer.BlockCopy (data, 0, buffer, pos, first);
+			System.Buffer.BlockCopy (data, first, buffer, 0, length - first);
+		}
+
+		void copy_out (int pos, byte[] data, int length)
+		{
+			int first = Math.Min (length, buffer.Length - pos);
+			System.Buffer.BlockCopy (buffer, pos, data, 0, first);
+			System.Buffer.BlockCopy (buffer, 0, data, first, length - first);
+		}
+
+		void write_int32 (int pos, int value)
+		{
+			copy_in (pos, BitConverter.GetBytes (value), 4);
+		}
+
+		int read_int32 (int pos)
+		{
+			byte[] data = new byte [4];
+			copy_out (pos, data, 4);
+			return BitConverter.ToInt32 (data, 0);
+		}
+
+		byte[][] get_records (out long first)
+		{
+			byte[][] records = new byte [count][];
+
+			int pos = start;
+			for (int i = 0; i < count; i++) {
+				int length = read_int32 (pos);
+				records [i] = new byte [length];
+				copy_out ((pos + 4) % buffer.Length, records [i], length);
+				pos = (pos + length + 4) % buffer.Length;
+			}
+
+			first = first_frame;
+			return records;
+		}
+
+		public TraceFrame[] GetFrames ()
+		{
+			byte[][] records;
+			long first;
+			string[] names;
+
+			lock (this) {
+				records = get_records (out first);
+				names = register_names;
+			}
+
+			TraceFrame[] frames = new TraceFrame [records.Length];
+			for (int i = 0; i < records.Length; i++)
+				frames [i] = new TraceFrame (first + i, records [i], names);
+			return frames;
+		}
+
+		//
+		// Dump files.
+		//
+
+		public void Save (Stream stream)
+		{
+			byte[][] records;
+			long first;
+			string[] names;
+
+			lock (this) {
+				records = get_records (out first);
+				names = register_names;
+			}
+
+			BinaryWriter w = new BinaryWriter (stream);
+			w.Write (Encoding.ASCII.GetBytes (Magic));
+			w.Write (Version);
+
+			w.Write (names.Length);
+			foreach (string name in names)
+				w.Write (name ?? "");
+
+			w.Write (first);
+			w.Write (records.Length);
+			foreach (byte[] record in records) {
+				w.Write (record.Length);
+				w.Write (record);
+			}
+
+			w.Flush ();
+		}
+
+		public static TraceFrame[] Load (Stream stream)
+		{
+			BinaryReader reader = new BinaryReader (stream);
+
+			string magic = Encoding.ASCII.GetString (reader.ReadBytes (Magic.Length));
+			if (magic != Magic)
+				throw new InvalidDataException ("Not a trace dump.");
+
+			int version = reader.ReadInt32 ();
+			if (version != Version)
+				throw new InvalidDataException (String.Format (
+					"Unknown trace dump version {0}.", version));
+
+			string[] names = new string [reader.ReadInt32 ()];
+			for (int i = 0; i < names.Length; i++)
+				names [i] = reader.ReadString ();
+
+			long first = reader.ReadInt64 ();
+			TraceFrame[] frames = new TraceFrame [reader.ReadInt32 ()];
+			for (int i = 0; i < frames.Length; i++) {
+				int length = reader.ReadInt32 ();
+				frames [i] = new TraceFrame (first + i, reader.ReadBytes (length), names);
+			}
+
+			return frames;
+		}
+	}
+}
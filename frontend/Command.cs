@@ -5,6 +5,7 @@ using System.IO;
 using System.Threading;
 using System.Reflection;
 using System.Collections;
+using System.Collections.Generic;
 using System.Globalization;
 using System.Text.RegularExpressions;
 using SD = System.Diagnostics;
@@ -65,10 +66,16 @@ namespace Mono.Debugger.Frontend
 			RegisterCommand ("activate", typeof (BreakpointActivateCommand));
 			RegisterCommand ("deactivate", typeof (BreakpointDeactivateCommand));
 			RegisterCommand ("delete", typeof (BreakpointDeleteCommand));
+			RegisterCommand ("condition", typeof (BreakpointConditionCommand));
+			RegisterCommand ("ignore", typeof (BreakpointIgnoreCommand));
+			RegisterCommand ("actions", typeof (TraceActionsCommand));
 			RegisterCommand ("list", typeof (ListCommand));
 			RegisterAlias   ("l", typeof (ListCommand));
 			RegisterCommand ("break", typeof (BreakCommand));
 			RegisterAlias   ("b", typeof (BreakCommand));
+			RegisterCommand ("trace", typeof (TraceCommand));
+			RegisterCommand ("tstatus", typeof (TraceStatusCommand));
+			RegisterCommand ("tdump", typeof (TraceDumpCommand));
 			RegisterCommand ("display", typeof (DisplayCommand));
 			RegisterAlias   ("d", typeof (DisplayCommand));
 			RegisterCommand ("undisplay", typeof (UndisplayCommand));
@@ -1985,6 +1992,50 @@ namespace Mono.Debugger.Frontend
 				return e.Completer.StringsCompleter (engine.Interpreter.GetStyleNames(), text);
 			}
 		}
+
+		private class SetSymbolCacheCommand : DebuggerCommand
+		{
+			protected override bool DoResolve (ScriptingContext context)
+			{
+				if (Argument == "")
+					throw new ScriptingException (
+						"Invalid argument: Expected `on', `off' or a directory");
+
+				return true;
+			}
+
+			protected override object DoExecute (ScriptingContext context)
+			{
+				DebuggerConfiguration config = context.Interpreter.DebuggerConfiguration;
+
+				switch (Argument) {
+				case "on":
+					config.SymbolCache = true;
+					break;
+				case "off":
+					config.SymbolCache = false;
+					break;
+				default:
+					config.SymbolCache = true;
+					config.SymbolCacheDirectory = Path.GetFullPath (Argument);
+					break;
+				}
+
+				config.SaveConfiguration ();
+				if (config.SymbolCache)
+					context.Print ("Symbol cache enabled in {0}; this applies to " +
+						       "modules which are loaded from now on.",
+						       config.SymbolCacheDirectory);
+				else
+					context.Print ("Symbol cache disabled.");
+				return null;
+			}
+
+			public override string[] Complete (Engine e, string text)
+			{
+				return e.Completer.FilenameCompleter (text);
+			}
+		}
 #endregion
 
 		private class AssignmentCommand : FrameCommand
@@ -2018,6 +2069,7 @@ namespace Mono.Debugger.Frontend
 			RegisterSubcommand ("env", typeof (SetEnvironmentCommand));
 			RegisterSubcommand ("args", typeof (SetArgsCommand));
 			RegisterSubcommand ("style", typeof (SetStyleCommand));
+			RegisterSubcommand ("symbol-cache", typeof (SetSymbolCacheCommand));
 		}
 
 		protected override bool DoResolve (ScriptingContext context)
@@ -2795,6 +2847,100 @@ namespace Mono.Debugger.Frontend
 		public string Documentation { get { return ""; } }
 	}
 
+	public class BreakpointConditionCommand : DebuggerCommand, IDocumentableCommand
+	{
+		Breakpoint breakpoint;
+		IBreakpointCondition condition;
+
+		protected override bool DoResolve (ScriptingContext context)
+		{
+			if ((Args == null) || (Args.Count < 1))
+				throw new ScriptingException (
+					"Invalid argument: Expected `BREAKPOINT [EXPRESSION]'");
+
+			int id;
+			try {
+				id = (int) UInt32.Parse ((string) Args [0]);
+			} catch {
+				context.Print ("breakpoint number expected.");
+				return false;
+			}
+
+			breakpoint = context.Interpreter.GetEvent (id) as Breakpoint;
+			if (breakpoint == null)
+				throw new ScriptingException ("Event {0} is not a breakpoint.", id);
+
+			if (Args.Count > 1) {
+				string[] expr = (string[]) Args.GetRange (1, Args.Count - 1).ToArray (typeof (string));
+				condition = context.Interpreter.ExpressionParser.ParseCondition (
+					String.Join (" ", expr));
+			}
+
+			return true;
+		}
+
+		protected override object DoExecute (ScriptingContext context)
+		{
+			breakpoint.Condition = condition;
+			if (condition == null)
+				context.Print ("Breakpoint {0} is now unconditional.", breakpoint.Index);
+			return null;
+		}
+
+		// IDocumentableCommand
+		public CommandFamily Family { get { return CommandFamily.Breakpoints; } }
+		public string Description { get { return "Set or remove a breakpoint's condition."; } }
+		public string Documentation { get { return "condition BREAKPOINT [EXPRESSION]\n\n" +
+					"The breakpoint only stops the target if EXPRESSION is true; without\n" +
+					"an EXPRESSION, the condition is removed.  The condition is evaluated\n" +
+					"each time the breakpoint is hit, so it may not invoke any methods."; } }
+	}
+
+	public class BreakpointIgnoreCommand : DebuggerCommand, IDocumentableCommand
+	{
+		Breakpoint breakpoint;
+		int count;
+
+		protected override bool DoResolve (ScriptingContext context)
+		{
+			if ((Args == null) || (Args.Count != 2))
+				throw new ScriptingException (
+					"Invalid argument: Expected `BREAKPOINT COUNT'");
+
+			int id;
+			try {
+				id = (int) UInt32.Parse ((string) Args [0]);
+				count = (int) UInt32.Parse ((string) Args [1]);
+			} catch {
+				context.Print ("breakpoint number and count expected.");
+				return false;
+			}
+
+			breakpoint = context.Interpreter.GetEvent (id) as Breakpoint;
+			if (breakpoint == null)
+				throw new ScriptingException ("Event {0} is not a breakpoint.", id);
+
+			return true;
+		}
+
+		protected override object DoExecute (ScriptingContext context)
+		{
+			breakpoint.IgnoreCount = count;
+			if (count == 0)
+				context.Print ("Will stop next time breakpoint {0} is reached.",
+					       breakpoint.Index);
+			else
+				context.Print ("Will ignore next {0} crossings of breakpoint {1}.",
+					       count, breakpoint.Index);
+			return null;
+		}
+
+		// IDocumentableCommand
+		public CommandFamily Family { get { return CommandFamily.Breakpoints; } }
+		public string Description { get { return "Ignore the next COUNT hits of a breakpoint."; } }
+		public string Documentation { get { return ""; } }
+	}
+
 	public abstract class SourceCommand : FrameCommand
 	{
 		protected LocationType type = LocationType.Method;
@@ -3266,22 +3412,30 @@ namespace Mono.Debugger.Frontend
 			return true;
 		}
 
+		protected virtual string EventName {
+			get { return "Breakpoint"; }
+		}
+
+		protected virtual bool IsTracepoint {
+			get { return false; }
+		}
+
 		protected override object DoExecute (ScriptingContext context)
 		{
 			Event handle;
 
 			if (!address.IsNull) {
 				handle = context.Interpreter.Session.InsertBreakpoint (
-					context.CurrentThread, tgroup, address);
-				context.Print ("Breakpoint {0} at {1}", handle.Index, address);
+					context.CurrentThread, tgroup, address, IsTracepoint);
+				context.Print ("{0} {1} at {2}", EventName, handle.Index, address);
 			} else if (location != null) {
 				handle = context.Interpreter.Session.InsertBreakpoint (
-					tgroup, location);
-				context.Print ("Breakpoint {0} at {1}", handle.Index, location.Name);
+					tgroup, location, IsTracepoint);
+				context.Print ("{0} {1} at {2}", EventName, handle.Index, location.Name);
 			} else {
 				handle = context.Interpreter.Session.InsertBreakpoint (
-					tgroup, type, Argument);
-				context.Print ("Breakpoint {0} at {1}", handle.Index, Argument);
+					tgroup, type, Argument, IsTracepoint);
+				context.Print ("{0} {1} at {2}", EventName, handle.Index, Argument);
 			}
 
 			if (gui) {
@@ -3307,6 +3461,14 @@ namespace Mono.Debugger.Frontend
 		{
 			// Do not repeat the break command.
 		}
+
+		public override string[] Complete (Engine e, string text)
+		{
+			if (text.StartsWith ("-"))
+				return e.Completer.ArgumentCompleter (GetType(), text);
+
+			return e.Completer.SymbolCompleter (text);
+		}
 		
 		// IDocumentableCommand
 		public CommandFamily Family { get { return CommandFamily.Breakpoints; } }
@@ -3314,6 +3476,260 @@ namespace Mono.Debugger.Frontend
 		public string Documentation { get { return ""; } }
 	}
 
+	public class TraceCommand : BreakCommand, IDocumentableCommand
+	{
+		protected override string EventName {
+			get { return "Tracepoint"; }
+		}
+
+		protected override bool IsTracepoint {
+			get { return true; }
+		}
+
+		// IDocumentableCommand
+		public new CommandFamily Family { get { return CommandFamily.Breakpoints; } }
+		public new string Description { get { return "Insert tracepoint."; } }
+		public new string Documentation { get { return
+					"Takes the same arguments as `break', but the target doesn't stop\n" +
+					"when the tracepoint is hit; the data specified with `actions' is\n" +
+					"collected into the trace buffer and the target is resumed.\n" +
+					"Use `tstatus' and `tdump' to look at the collected data."; } }
+	}
+
+	public class TraceActionsCommand : DebuggerCommand, IDocumentableCommand
+	{
+		Breakpoint breakpoint;
+		TraceAction[] actions;
+
+		protected override bool DoResolve (ScriptingContext context)
+		{
+			if ((Args == null) || (Args.Count < 1))
+				throw new ScriptingException (
+					"Invalid argument: Expected `TRACEPOINT [ACTION; ...]'");
+
+			int id;
+			try {
+				id = (int) UInt32.Parse ((string) Args [0]);
+			} catch {
+				context.Print ("tracepoint number expected.");
+				return false;
+			}
+
+			breakpoint = context.Interpreter.GetEvent (id) as Breakpoint;
+			if ((breakpoint == null) || !breakpoint.IsTracepoint)
+				throw new ScriptingException ("Event {0} is not a tracepoint.", id);
+
+			if (Args.Count == 1)
+				return true;
+
+			string[] args = (string[]) Args.GetRange (1, Args.Count - 1).ToArray (typeof (string));
+			List<TraceAction> list = new List<TraceAction> ();
+			foreach (string text in String.Join (" ", args).Split (';')) {
+				string action = text.Trim ();
+				if (action == "")
+					continue;
+
+				list.Add (ParseAction (context, action));
+			}
+
+			actions = list.ToArray ();
+			return true;
+		}
+
+		static TraceAction ParseAction (ScriptingContext context, string text)
+		{
+			ExpressionParser parser = context.Interpreter.ExpressionParser;
+
+			if (text == "$regs")
+				return new TraceAction ();
+
+			if (!text.StartsWith ("$mem "))
+				return new TraceAction (parser.ParseTraceExpression (text));
+
+			string arg = text.Substring (5).Trim ();
+			int pos = arg.LastIndexOf (' ');
+			uint length;
+			if ((pos < 0) || !UInt32.TryParse (arg.Substring (pos + 1), out length) ||
+			    (length == 0))
+				throw new ScriptingException (
+					"Invalid action: Expected `$mem ADDRESS LENGTH'");
+
+			return new TraceAction (
+				parser.ParseTraceExpression (arg.Substring (0, pos)), (int) length);
+		}
+
+		protected override object DoExecute (ScriptingContext context)
+		{
+			if (actions != null) {
+				breakpoint.TraceActions = actions;
+				return null;
+			}
+
+			if (breakpoint.TraceActions.Length == 0) {
+				context.Print ("Tracepoint {0} has no actions.", breakpoint.Index);
+				return null;
+			}
+
+			context.Print ("Tracepoint {0} collects:", breakpoint.Index);
+			foreach (TraceAction action in breakpoint.TraceActions)
+				context.Print ("\t{0}", action);
+			return null;
+		}
+
+		// IDocumentableCommand
+		public CommandFamily Family { get { return CommandFamily.Breakpoints; } }
+		public string Description { get { return "Set or show the actions of a tracepoint."; } }
+		public string Documentation { get { return "actions TRACEPOINT [ACTION; ...]\n\n" +
+					"Replaces the tracepoint's actions; without any ACTIONs, prints them.\n" +
+					"Each ACTION is one of\n\n" +
+					"  $regs                    collect the registers\n" +
+					"  $mem ADDRESS LENGTH      collect LENGTH bytes of memory at ADDRESS\n" +
+					"  EXPRESSION               collect the value of EXPRESSION\n\n" +
+					"Expressions are evaluated each time the tracepoint is hit, so they\n" +
+					"may not invoke any methods."; } }
+	}
+
+	public class TraceStatusCommand : DebuggerCommand, IDocumentableCommand
+	{
+		bool reset;
+
+		public bool Reset {
+			get { return reset; }
+			set { reset = value; }
+		}
+
+		protected override object DoExecute (ScriptingContext context)
+		{
+			TraceBuffer buffer = context.CurrentProcess.TraceBuffer;
+
+			context.Print ("Trace buffer: {0} frames, {1} of {2} bytes used.",
+				       buffer.Count, buffer.Used, buffer.Size);
+			context.Print ("Collected {0} frames, {1} dropped, {2} errors.",
+				       buffer.Collected, buffer.Dropped, buffer.Errors);
+			context.Print ("Overhead per hit: {0:0.0} us average, {1:0.0} us maximum.",
+				       buffer.AverageOverhead.TotalMilliseconds * 1000,
+				       buffer.MaximumOverhead.TotalMilliseconds * 1000);
+
+			foreach (Event handle in context.Interpreter.Session.Events) {
+				Breakpoint bpt = handle as Breakpoint;
+				if ((bpt == null) || !bpt.IsTracepoint)
+					continue;
+
+				context.Print ("Tracepoint {0} ({1}): {2} hits, {3} actions{4}.",
+					       bpt.Index, bpt.Name, bpt.HitCount, bpt.TraceActions.Length,
+					       bpt.IsEnabled ? "" : ", disabled");
+			}
+
+			if (reset)
+				buffer.Clear ();
+
+			return null;
+		}
+
+		// IDocumentableCommand
+		public CommandFamily Family { get { return CommandFamily.Breakpoints; } }
+		public string Description { get { return "Show the status of the trace buffer."; } }
+		public string Documentation { get { return
+					"With -reset, discards the collected data and resets the counters."; } }
+	}
+
+	public class TraceDumpCommand : DebuggerCommand, IDocumentableCommand
+	{
+		string output, input;
+		long frame = -1;
+
+		public string Output {
+			get { return output; }
+			set { output = value; }
+		}
+
+		public string Input {
+			get { return input; }
+			set { input = value; }
+		}
+
+		protected override bool DoResolve (ScriptingContext context)
+		{
+			if ((output != null) && (input != null))
+				throw new ScriptingException ("Cannot use both -output and -input.");
+
+			if (Argument != "") {
+				if (!Int64.TryParse (Argument, out frame) || (frame < 0))
+					throw new ScriptingException ("Trace frame number expected.");
+			}
+
+			return true;
+		}
+
+		protected override object DoExecute (ScriptingContext context)
+		{
+			if (output != null) {
+				using (FileStream stream = new FileStream (output, FileMode.Create))
+					context.CurrentProcess.TraceBuffer.Save (stream);
+				context.Print ("Saved trace buffer to `{0}'.", output);
+				return null;
+			}
+
+			TraceFrame[] frames;
+			if (input != null) {
+				try {
+					using (FileStream stream = new FileStream (input, FileMode.Open))
+						frames = TraceBuffer.Load (stream);
+				} catch (Exception ex) {
+					throw new ScriptingException (
+						"Cannot read trace dump `{0}': {1}", input, ex.Message);
+				}
+			} else
+				frames = context.CurrentProcess.TraceBuffer.GetFrames ();
+
+			bool found = false;
+			foreach (TraceFrame tframe in frames) {
+				if ((frame >= 0) && (tframe.Number != frame))
+					continue;
+
+				found = true;
+				PrintFrame (context, tframe);
+			}
+
+			if (!found) {
+				if (frame >= 0)
+					throw new ScriptingException ("No such trace frame: {0}", frame);
+				context.Print ("No trace frames.");
+			}
+
+			return null;
+		}
+
+		static void PrintFrame (ScriptingContext context, TraceFrame frame)
+		{
+			context.Print ("#{0}: tracepoint {1}, thread @{2}, {3:HH:mm:ss.ffffff}, 0x{4:x}",
+				       frame.Number, frame.Tracepoint, frame.ThreadID,
+				       frame.Time, frame.Address);
+
+			if (frame.Registers.Length > 0) {
+				StringBuilder sb = new StringBuilder ("\t");
+				foreach (KeyValuePair<string,long> reg in frame.Registers)
+					sb.AppendFormat ("{0}=0x{1:x} ", reg.Key, reg.Value);
+				context.Print (sb.ToString ().TrimEnd ());
+			}
+
+			foreach (KeyValuePair<long,byte[]> memory in frame.Memory)
+				context.Print ("\t0x{0:x}: {1}", memory.Key,
+					       BitConverter.ToString (memory.Value).Replace ("-", " "));
+
+			foreach (KeyValuePair<string,string> value in frame.Values)
+				context.Print ("\t{0} = {1}", value.Key, value.Value);
+		}
+
+		// IDocumentableCommand
+		public CommandFamily Family { get { return CommandFamily.Breakpoints; } }
+		public string Description { get { return "Print or save the collected trace frames."; } }
+		public string Documentation { get { return "tdump [FRAME]\n\n" +
+					"Prints all trace frames or only FRAME.\n" +
+					"With -output FILE, saves the trace buffer to FILE in a binary format.\n" +
+					"With -input FILE, prints the frames from such a file instead."; } }
+	}
+
 	public class CatchCommand : FrameCommand, IDocumentableCommand
 	{
 		string group;
@@ -3872,6 +4288,10 @@ namespace Mono.Debugger.Frontend
 					config.RedirectOutput = enable;
 					break;
 
+				case "symbol-cache":
+					config.SymbolCache = enable;
+					break;
+
 				case "stop-daemon":
 					require_expert_mode ();
 					if (enable)
@@ -12,6 +12,7 @@ namespace Mono.Debugger.Frontend
 
 	public class Completer {
 		private Engine engine;
+		private SymbolNameIndex symbol_index = new SymbolNameIndex ();
 
 		public Completer (Engine engine) {
 			this.engine = engine;
@@ -160,50 +161,53 @@ namespace Mono.Debugger.Frontend
 			return null;
 		}
 
+		/* SymbolCompleter: completes method, type, namespace and
+		 * source file names, also relative to the namespaces which
+		 * are in scope in the current frame. */
 		public string[] SymbolCompleter (ScriptingContext context, string text)
 		{
 			try {
-				var method_list = new List<string> ();
-				string[] namespaces = context.GetNamespaces();
-				Module[] modules = context.CurrentProcess.Modules;
-
-				foreach (Module module in modules) {
-					if (!module.SymbolsLoaded || !module.SymbolTable.HasMethods)
-						continue;
-
-					SourceFile[] sources = module.Sources;
-					if (sources == null)
-						continue;
-
-					foreach (SourceFile sf in sources) {
-						foreach (MethodSource method in sf.Methods) {
-							if (method.Name.StartsWith (text)) {
-								int parameter_start = method.Name.IndexOf ('(');
-								if (parameter_start != -1)
-									method_list.Add (method.Name.Substring (0, parameter_start));
-								else
-									method_list.Add (method.Name);
-							}
-							if (namespaces != null) {
-								foreach (string n in namespaces) {
-									if (n != "" && method.Name.StartsWith (String.Concat (n, ".", text))) {
-										int parameter_start = method.Name.IndexOf ('(');
-										if (parameter_start != -1)
-											method_list.Add (method.Name.Substring (n.Length + 1,
-																parameter_start - n.Length - 1));
-										else
-											method_list.Add (method.Name.Substring (n.Length + 1));
-									}
-								}
-							}
-						}
+				symbol_index.Update (context.CurrentProcess.Modules);
+
+				var matches = new List<string> (symbol_index.Complete (text));
+
+				string[] namespaces = context.GetNamespaces ();
+				if (namespaces != null) {
+					foreach (string n in namespaces) {
+						if (n == "")
+							continue;
+
+						foreach (string name in symbol_index.Complete (String.Concat (n, ".", text)))
+							matches.Add (name.Substring (n.Length + 1));
 					}
 				}
 
-				return method_list.ToArray ();
+				return matches.ToArray ();
 			} catch {
 				return null;
 			}
 		}
+
+		public string[] SymbolCompleter (string text)
+		{
+			DebuggerEngine de = engine as DebuggerEngine;
+			if ((de == null) || !de.Interpreter.HasCurrentProcess)
+				return null;
+
+			ScriptingContext context = new ScriptingContext (de.Interpreter);
+			context.CurrentProcess = de.Interpreter.CurrentProcess;
+
+			try {
+				if (de.Interpreter.HasCurrentThread) {
+					Thread thread = de.Interpreter.CurrentThread;
+					if (thread.IsStopped)
+						context.CurrentFrame = thread.CurrentFrame;
+				}
+			} catch {
+				// We just won't complete relative to the current namespaces.
+			}
+
+			return SymbolCompleter (context, text);
+		}
 	}
 }
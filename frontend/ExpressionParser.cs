@@ -3,6 +3,7 @@ using System.Text;
 using System.IO;
 using System.Reflection;
 using System.Collections;
+using System.Collections.Generic;
 using System.Globalization;
 using ST=System.Threading;
 using Mono.Debugger;
@@ -147,6 +148,26 @@ namespace Mono.Debugger.Frontend
 			}
 		}
 
+		public IBreakpointCondition ParseCondition (string text)
+		{
+			try {
+				ParseInternal (text);
+				return new BreakpointCondition (this, text);
+			} catch (ExpressionParsingException ex) {
+				throw new ScriptingException (ex.ToString ());
+			}
+		}
+
+		public ITraceExpression ParseTraceExpression (string text)
+		{
+			try {
+				ParseInternal (text);
+				return new TraceExpression (this, text);
+			} catch (ExpressionParsingException ex) {
+				throw new ScriptingException (ex.ToString ());
+			}
+		}
+
 		public string EvaluateExpression (ScriptingContext context, string text,
 						  DisplayFormat format)
 		{
@@ -332,6 +353,116 @@ namespace Mono.Debugger.Frontend
 			}
 		}
 
+		// <summary>
+		//   Breakpoint conditions and trace expressions are evaluated on the
+		//   engine thread each time the breakpoint is hit.  They're parsed
+		//   and resolved once for each method they're evaluated in; the
+		//   resolved expression is reused on each subsequent hit.  Since
+		//   resolving modifies the expression tree, each method gets its own
+		//   copy.
+		// </summary>
+		protected abstract class EngineExpression
+		{
+			public readonly ExpressionParser Parser;
+			readonly string text;
+			readonly Dictionary<Method,F.Expression> resolved;
+
+			protected EngineExpression (ExpressionParser parser, string text)
+			{
+				this.Parser = parser;
+				this.text = text;
+				this.resolved = new Dictionary<Method,F.Expression> ();
+			}
+
+			public string Text {
+				get { return text; }
+			}
+
+			protected F.Expression Resolve (StackFrame frame, out ScriptingContext context)
+			{
+				context = new ScriptingContext (Parser.Interpreter);
+				context.CurrentFrame = frame;
+				context.ScriptingFlags |= ScriptingFlags.NoInvocation;
+
+				F.Expression expr;
+				Method method = frame.Method;
+				lock (resolved) {
+					if ((method == null) || !resolved.TryGetValue (method, out expr)) {
+						expr = context.ParseExpression (text).Resolve (context);
+						if (method != null)
+							resolved [method] = expr;
+					}
+				}
+
+				return expr;
+			}
+
+			public override string ToString ()
+			{
+				return text;
+			}
+		}
+
+		protected class BreakpointCondition : EngineExpression, IBreakpointCondition
+		{
+			public BreakpointCondition (ExpressionParser parser, string text)
+				: base (parser, text)
+			{ }
+
+			public bool Evaluate (StackFrame frame)
+			{
+				ScriptingContext context;
+				F.Expression expr = Resolve (frame, out context);
+
+				object result = expr.Evaluate (context);
+			again:
+				if (result is bool)
+					return (bool) result;
+				else if (result is TargetFundamentalObject) {
+					TargetFundamentalObject fobj = (TargetFundamentalObject) result;
+					result = fobj.GetObject (frame.Thread);
+					goto again;
+				} else if (result is IConvertible)
+					return System.Convert.ToInt64 (result) != 0;
+
+				throw new ScriptingException (
+					"Cannot convert `{0}' to a boolean.", Text);
+			}
+		}
+
+		protected class TraceExpression : EngineExpression, ITraceExpression
+		{
+			public TraceExpression (ExpressionParser parser, string text)
+				: base (parser, text)
+			{ }
+
+			public string Evaluate (StackFrame frame)
+			{
+				ScriptingContext context;
+				F.Expression expr = Resolve (frame, out context);
+
+				return context.FormatObject (expr.Evaluate (context), DisplayFormat.Default);
+			}
+
+			public TargetAddress EvaluateAddress (StackFrame frame)
+			{
+				ScriptingContext context;
+				F.Expression expr = Resolve (frame, out context);
+
+				PointerExpression pexpr = expr as PointerExpression;
+				if (pexpr != null)
+					return pexpr.EvaluateAddress (context);
+
+				// Otherwise, collect the object's own storage.
+				TargetObject obj = expr.EvaluateObject (context);
+				if ((obj == null) || !obj.HasAddress)
+					throw new ScriptingException (
+						"Expression `{0}' doesn't have an address.", Text);
+
+				return obj.GetAddress (frame.Thread);
+			}
+		}
+
 		public class AsyncResult : EE.AsyncResult, IInterruptionHandler
 		{
 			public readonly Expression Expression;
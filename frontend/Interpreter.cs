@@ -446,6 +446,8 @@ namespace Mono.Debugger.Frontend
 
 				if (handle is ExceptionCatchPoint)
 					type = "catch";
+				else if ((handle is Breakpoint) && ((Breakpoint) handle).IsTracepoint)
+					type = "trace";
 				else
 					type = "break";
 
@@ -455,6 +457,17 @@ namespace Mono.Debugger.Frontend
 				       handle.IsActivated ? "y" : "n",
 				       handle.ThreadGroup != null ? handle.ThreadGroup.Name : "global",
 				       handle.Name);
+
+				Breakpoint bpt = handle as Breakpoint;
+				if (bpt == null)
+					continue;
+				if (bpt.Condition != null)
+					Print ("\tstop only if {0}", bpt.Condition.Text);
+				if (bpt.HitCount > 0)
+					Print ("\tbreakpoint already hit {0} time{1}", bpt.HitCount,
+					       bpt.HitCount == 1 ? "" : "s");
+				if (bpt.IgnoreCount > 0)
+					Print ("\twill ignore next {0} crossings of breakpoint", bpt.IgnoreCount);
 			}
 		}
 
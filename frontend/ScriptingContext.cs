@@ -46,7 +46,8 @@ namespace Mono.Debugger.Frontend
 	public enum ScriptingFlags
 	{
 		None			= 0,
-		NestedBreakStates	= 1
+		NestedBreakStates	= 1,
+		NoInvocation		= 2
 	}
 
 	public interface IInterruptionHandler
@@ -266,6 +267,10 @@ namespace Mono.Debugger.Frontend
 							  TargetObject[] param_objects,
 							  RuntimeInvokeFlags flags)
 		{
+			if ((ScriptingFlags & ScriptingFlags.NoInvocation) != 0)
+				throw new ScriptingException (
+					"Cannot invoke methods in a breakpoint condition.");
+
 			IInterruptionHandler interruption = InterruptionHandler ?? Interpreter;
 			if (interruption.CheckInterruption ())
 				throw new EvaluationTimeoutException ();
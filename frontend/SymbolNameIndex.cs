@@ -0,0 +1,190 @@
+using System;
+using System.Collections.Generic;
+
+namespace Mono.Debugger.Frontend
+{
+	// <summary>
+	//   A sorted array of all method, type, namespace and source file names of
+	//   the loaded modules, used for TAB completion.
+	//
+	//   Each module's names are collected once, when we first see it with its
+	//   symbols loaded; the names of all new modules are sorted together and
+	//   merged into the sorted array in one go.  A completion is just a binary
+	//   search for the prefix, so it doesn't depend on the number of loaded
+	//   modules.  Type and namespace names are derived from the method names
+	//   ("A.B.C.Foo" also adds "A", "A.B" and "A.B.C").
+	//
+	//   This is only updated when completing, so loading a module doesn't
+	//   read all its source files just for us.
+	// </summary>
+	public class SymbolNameIndex
+	{
+		Dictionary<string,string[]> modules = new Dictionary<string,string[]> ();
+		string[] names = new string [0];
+
+		// <summary>
+		//   Index all new modules and drop the ones which are gone or whose
+		//   symbols have been unloaded.
+		// </summary>
+		public void Update (Module[] current)
+		{
+			lock (this) {
+				var seen = new Dictionary<string,Module> ();
+				foreach (Module module in current) {
+					if (!module.SymbolsLoaded || !module.SymbolTable.HasMethods)
+						continue;
+
+					seen [module.Name] = module;
+				}
+
+				bool removed = false;
+				foreach (string name in new List<string> (modules.Keys)) {
+					if (seen.ContainsKey (name))
+						continue;
+
+					modules.Remove (name);
+					removed = true;
+				}
+
+				if (removed)
+					names = sort_names (modules.Values);
+
+				var added = new List<string[]> ();
+				foreach (Module module in seen.Values) {
+					if (modules.ContainsKey (module.Name))
+						continue;
+
+					string[] module_names = get_names (module);
+					modules.Add (module.Name, module_names);
+					added.Add (module_names);
+				}
+
+				if (added.Count > 0)
+					names = merge (names, sort_names (added));
+			}
+		}
+
+		public void Clear ()
+		{
+			lock (this) {
+				modules.Clear ();
+				names = new string [0];
+			}
+		}
+
+		// <summary>
+		//   Returns all names starting with `prefix'.
+		// </summary>
+		public string[] Complete (string prefix)
+		{
+			lock (this) {
+				int start = lower_bound (prefix);
+				int end = start;
+				while ((end < names.Length) &&
+				       names [end].StartsWith (prefix, StringComparison.Ordinal))
+					end++;
+
+				string[] result = new string [end - start];
+				Array.Copy (names, start, result, 0, result.Length);
+				return result;
+			}
+		}
+
+		int lower_bound (string key)
+		{
+			int lo = 0, hi = names.Length;
+			while (lo < hi) {
+				int mid = (lo + hi) / 2;
+				if (String.CompareOrdinal (names [mid], key) < 0)
+					lo = mid + 1;
+				else
+					hi = mid;
+			}
+			return lo;
+		}
+
+		// <summary>
+		//   Sort the names of several modules, removing duplicates.
+		// </summary>
+		static string[] sort_names (IEnumerable<string[]> module_names)
+		{
+			var all = new List<string> ();
+			foreach (string[] list in module_names)
+				all.AddRange (list);
+
+			all.Sort (StringComparer.Ordinal);
+			return merge (all.ToArray (), new string [0]);
+		}
+
+		static string[] get_names (Module module)
+		{
+			var set = new Dictionary<string,bool> ();
+
+			try {
+				SourceFile[] sources = module.Sources;
+				if (sources == null)
+					return new string [0];
+
+				foreach (SourceFile file in sources) {
+					set [file.Name] = true;
+
+					foreach (MethodSource method in file.Methods) {
+						string name = method.Name;
+						int parameter_start = name.IndexOf ('(');
+						if (parameter_start != -1)
+							name = name.Substring (0, parameter_start);
+
+						set [name] = true;
+
+						// All the enclosing types and namespaces.
+						int pos = name.IndexOf ('.');
+						while (pos > 0) {
+							set [name.Substring (0, pos)] = true;
+							pos = name.IndexOf ('.', pos + 1);
+						}
+					}
+				}
+			} catch {
+				// Index what we've got so far.
+			}
+
+			string[] result = new string [set.Count];
+			set.Keys.CopyTo (result, 0);
+			Array.Sort (result, StringComparer.Ordinal);
+			return result;
+		}
+
+		// <summary>
+		//   Merge two sorted arrays, removing duplicates.
+		// </summary>
+		static string[] merge (string[] a, string[] b)
+		{
+			var result = new List<string> (a.Length + b.Length);
+			int i = 0, j = 0;
+			while ((i < a.Length) || (j < b.Length)) {
+				string next;
+				if (j == b.Length)
+					next = a [i++];
+				else if (i == a.Length)
+					next = b [j++];
+				else {
+					int cmp = String.CompareOrdinal (a [i], b [j]);
+					if (cmp < 0)
+						next = a [i++];
+					else if (cmp > 0)
+						next = b [j++];
+					else {
+						next = a [i++];
+						j++;
+					}
+				}
+
+				if ((result.Count == 0) ||
+				    (String.CompareOrdinal (result [result.Count - 1], next) != 0))
+					result.Add (next);
+			}
+
+			return result.ToArray ();
+		}
+	}
+}
@@ -30,10 +30,7 @@ namespace Mono.Debugger.Languages
 			if (size > blob.Size)
 				throw new ArgumentException ();
 
-			byte[] data = new byte [size];
-			Array.Copy (blob.Contents, 0, data, 0, size);
-
-			return new TargetBlob (data, blob.TargetMemoryInfo);
+			return blob.GetSlice (0, size);
 		}
 
 		internal override void WriteBuffer (TargetMemoryAccess target, byte[] data)
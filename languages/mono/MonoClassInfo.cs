@@ -97,9 +97,8 @@ namespace Mono.Debugger.Languages.Mono
 			this.KlassAddress = klass;
 			this.CecilType = typedef;
 
-			parent_klass = MetadataHelper.MonoClassGetParent (target, klass);
-			GenericClass = MetadataHelper.MonoClassGetGenericClass (target, klass);
-			GenericContainer = MetadataHelper.MonoClassGetGenericContainer (target, klass);
+			MetadataHelper.MonoClassGetHierarchy (
+				target, klass, out parent_klass, out GenericClass, out GenericContainer);
 		}
 
 		protected MetadataHelper MetadataHelper {
@@ -132,20 +131,17 @@ namespace Mono.Debugger.Languages.Mono
 			if ((field_count != 0) && !MetadataHelper.MonoClassHasFields (target, KlassAddress))
 				throw new TargetException (TargetError.ClassNotInitialized);
 
+			TargetAddress[] type_addrs;
+			MetadataHelper.MonoClassGetFields (
+				target, KlassAddress, field_count, out type_addrs, out field_offsets);
+
 			fields = new MonoFieldInfo [field_count];
-			field_offsets = new int [field_count];
 			field_types = new TargetType [field_count];
 
 			for (int i = 0; i < field_count; i++) {
 				Cecil.FieldDefinition field = CecilType.Fields [i];
 
-				TargetAddress type_addr = MetadataHelper.MonoClassGetFieldType (
-					target, KlassAddress, i);
-
-				field_types [i] = SymbolFile.MonoLanguage.ReadType (target, type_addr);
-				field_offsets [i] = MetadataHelper.MonoClassGetFieldOffset (
-					target, KlassAddress, i);
-
+				field_types [i] = SymbolFile.MonoLanguage.ReadType (target, type_addrs [i]);
 				fields [i] = new MonoFieldInfo (struct_type, field_types [i], i, field);
 			}
 
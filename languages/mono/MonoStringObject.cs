@@ -1,4 +1,5 @@
 using System;
+using System.Text;
 
 using Mono.Debugger.Backend;
 using Mono.Debugger.Backend.Mono;
@@ -37,15 +38,9 @@ namespace Mono.Debugger.Languages.Mono
 
 			TargetBlob blob = dynamic_location.ReadMemory (target, (int) size);
 
-			TargetBinaryReader reader = blob.GetReader ();
-			int length = (int) reader.Size / 2;
-
-			char[] retval = new char [length];
-
-			for (int i = 0; i < length; i++)
-				retval [i] = (char) reader.ReadInt16 ();
-
-			return new String (retval);
+			Encoding encoding = blob.TargetMemoryInfo.IsBigEndian ?
+				Encoding.BigEndianUnicode : Encoding.Unicode;
+			return encoding.GetString (blob.Contents, 0, blob.Size & ~1);
 		}
 
 		internal static string ReadString (MonoLanguageBackend mono, TargetMemoryAccess target,
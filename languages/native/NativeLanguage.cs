@@ -113,11 +113,14 @@ namespace Mono.Debugger.Languages.Native
 
 		public void AddType (ITypeEntry entry)
 		{
-			if (!type_hash.Contains (entry.Name))
-				type_hash.Add (entry.Name, entry);
+			// The DwarfReader adds types from several threads at once.
+			lock (type_hash.SyncRoot) {
+				if (!type_hash.Contains (entry.Name))
+					type_hash.Add (entry.Name, entry);
 
-			if (entry.IsComplete)
-				type_hash [entry.Name] = entry;
+				if (entry.IsComplete)
+					type_hash [entry.Name] = entry;
+			}
 		}
 
 		TargetFundamentalType GetFundamentalType (Type type)
@@ -72,6 +72,12 @@ namespace Mono.CompilerServices.SymbolWriter
 			return base.Read7BitEncodedInt ();
 		}
 
+		public void SkipString ()
+		{
+			int length = base.Read7BitEncodedInt ();
+			BaseStream.Position += length;
+		}
+
 		public string ReadString (int offset)
 		{
 			long old_pos = BaseStream.Position;
@@ -384,9 +390,16 @@ namespace Mono.CompilerServices.SymbolWriter
 		Hashtable source_file_hash;
 		Hashtable compile_unit_hash;
 
-		ArrayList method_list;
-		Hashtable method_token_hash;
+		//
+		// The method table has fixed-size entries, so we decode them on demand.
+		// `method_tokens' is sorted and `method_token_index [i]' is the index
+		// of the method with token `method_tokens [i]'.
+		//
+		MethodEntry[] method_list;
+		int[] method_tokens;
+		int[] method_token_index;
 		Hashtable source_name_hash;
+		Hashtable anonymous_scope_offsets;
 
 		Guid guid;
 
@@ -394,9 +407,13 @@ namespace Mono.CompilerServices.SymbolWriter
 		{
 			this.FileName = filename;
 
-			FileStream stream;
+			//
+			// We keep the file open and seek to the offset table and to the
+			// individual entries on demand, so only the parts of the file
+			// which are actually used are ever read into memory.
+			//
 			try {
-				stream = new FileStream (filename, FileMode.Open, FileAccess.Read);
+				FileStream stream = new FileStream (filename, FileMode.Open, FileAccess.Read);
 				reader = new MyBinaryReader (stream);
 			} catch (IOException ex) {
 				throw new MonoSymbolFileException (
@@ -605,36 +622,62 @@ namespace Mono.CompilerServices.SymbolWriter
 			}
 		}
 
-		void read_methods ()
+		void read_method_tokens ()
 		{
 			lock (this) {
-				if (method_token_hash != null)
+				if (method_tokens != null)
 					return;
 
-				method_token_hash = new Hashtable ();
-				method_list = new ArrayList ();
-
 				long old_pos = reader.BaseStream.Position;
-				reader.BaseStream.Position = ot.MethodTableOffset;
 
+				int[] tokens = new int [MethodCount];
+				int[] indices = new int [MethodCount];
 				for (int i = 0; i < MethodCount; i++) {
-					MethodEntry entry = new MethodEntry (this, reader, i + 1);
-					method_token_hash.Add (entry.Token, entry);
-					method_list.Add (entry);
+					reader.BaseStream.Position = ot.MethodTableOffset +
+						MethodEntry.Size * i;
+					tokens [i] = reader.ReadInt32 ();
+					indices [i] = i + 1;
 				}
 
 				reader.BaseStream.Position = old_pos;
+
+				Array.Sort (tokens, indices);
+				method_token_index = indices;
+				method_tokens = tokens;
 			}
 		}
 
+		MethodEntry read_method (int index)
+		{
+			if (method_list == null)
+				method_list = new MethodEntry [MethodCount];
+
+			MethodEntry entry = method_list [index - 1];
+			if (entry != null)
+				return entry;
+
+			long old_pos = reader.BaseStream.Position;
+			reader.BaseStream.Position = ot.MethodTableOffset +
+				MethodEntry.Size * (index - 1);
+
+			entry = new MethodEntry (this, reader, index);
+			method_list [index - 1] = entry;
+
+			reader.BaseStream.Position = old_pos;
+			return entry;
+		}
+
 		public MethodEntry GetMethodByToken (int token)
 		{
 			if (reader == null)
 				throw new InvalidOperationException ();
 
 			lock (this) {
-				read_methods ();
-				return (MethodEntry) method_token_hash [token];
+				read_method_tokens ();
+				int pos = Array.BinarySearch (method_tokens, token);
+				if (pos < 0)
+					return null;
+				return read_method (method_token_index [pos]);
 			}
 		}
 
@@ -646,8 +689,7 @@ namespace Mono.CompilerServices.SymbolWriter
 				throw new InvalidOperationException ();
 
 			lock (this) {
-				read_methods ();
-				return (MethodEntry) method_list [index - 1];
+				return read_method (index);
 			}
 		}
 
@@ -657,9 +699,9 @@ namespace Mono.CompilerServices.SymbolWriter
 					throw new InvalidOperationException ();
 
 				lock (this) {
-					read_methods ();
 					MethodEntry[] retval = new MethodEntry [MethodCount];
-					method_list.CopyTo (retval, 0);
+					for (int i = 0; i < MethodCount; i++)
+						retval [i] = read_method (i + 1);
 					return retval;
 				}
 			}
@@ -674,10 +716,20 @@ namespace Mono.CompilerServices.SymbolWriter
 				if (source_name_hash == null) {
 					source_name_hash = new Hashtable ();
 
+					//
+					// Only read the names here, the SourceFileEntries
+					// are created on demand by GetSourceFile().
+					//
+					long old_pos = reader.BaseStream.Position;
 					for (int i = 0; i < ot.SourceCount; i++) {
-						SourceFileEntry source = GetSourceFile (i + 1);
-						source_name_hash.Add (source.FileName, i);
+						reader.BaseStream.Position = ot.SourceTableOffset +
+							SourceFileEntry.Size * i + 4;
+						int data_offset = reader.ReadInt32 ();
+						string name = reader.ReadString (data_offset);
+						if (!source_name_hash.Contains (name))
+							source_name_hash.Add (name, i);
 					}
+					reader.BaseStream.Position = old_pos;
 				}
 
 				object value = source_name_hash [file_name];
@@ -687,25 +739,66 @@ namespace Mono.CompilerServices.SymbolWriter
 			}
 		}
 
+		//
+		// Anonymous scopes have variable size, so we can't index them directly;
+		// instead, we only record each scope's offset in one pass and decode it
+		// when it's actually requested.
+		//
 		void read_scopes ()
 		{
 			lock (this) {
-				if (anonymous_scopes != null)
+				if (anonymous_scope_offsets != null)
 					return;
 
 				long old_pos = reader.BaseStream.Position;
 				reader.BaseStream.Position = ot.AnonymousScopeTableOffset;
 
+				anonymous_scope_offsets = new Hashtable ();
 				anonymous_scopes = new Hashtable ();
 				for (int i = 0; i < ot.AnonymousScopeCount; i++) {
-					AnonymousScopeEntry scope = new AnonymousScopeEntry (reader);
-					anonymous_scopes.Add (scope.ID, scope);
+					int offset = (int) reader.BaseStream.Position;
+					int id = reader.ReadLeb128 ();
+
+					int num_captured_vars = reader.ReadLeb128 ();
+					for (int j = 0; j < num_captured_vars; j++) {
+						reader.SkipString ();
+						reader.SkipString ();
+						reader.ReadByte ();
+					}
+
+					int num_captured_scopes = reader.ReadLeb128 ();
+					for (int j = 0; j < num_captured_scopes; j++) {
+						reader.ReadLeb128 ();
+						reader.SkipString ();
+					}
+
+					anonymous_scope_offsets.Add (id, offset);
 				}
 
 				reader.BaseStream.Position = old_pos;
 			}
 		}
 
+		AnonymousScopeEntry read_scope (int id)
+		{
+			AnonymousScopeEntry scope = (AnonymousScopeEntry) anonymous_scopes [id];
+			if (scope != null)
+				return scope;
+
+			object offset = anonymous_scope_offsets [id];
+			if (offset == null)
+				return null;
+
+			long old_pos = reader.BaseStream.Position;
+			reader.BaseStream.Position = (int) offset;
+
+			scope = new AnonymousScopeEntry (reader);
+			anonymous_scopes.Add (id, scope);
+
+			reader.BaseStream.Position = old_pos;
+			return scope;
+		}
+
 		public AnonymousScopeEntry GetAnonymousScope (int id)
 		{
 			if (reader == null)
@@ -713,16 +806,23 @@ namespace Mono.CompilerServices.SymbolWriter
 
 			lock (this) {
 				read_scopes ();
-				return (AnonymousScopeEntry) anonymous_scopes [id];
+				return read_scope (id);
 			}
 		}
 
 		public AnonymousScopeEntry[] AnonymousScopes {
 			get {
-				read_scopes ();
-				AnonymousScopeEntry[] scopes = new AnonymousScopeEntry [anonymous_scopes.Count];
-				anonymous_scopes.Values.CopyTo (scopes, 0);
-				return scopes;
+				if (reader == null)
+					throw new InvalidOperationException ();
+
+				lock (this) {
+					read_scopes ();
+					AnonymousScopeEntry[] scopes = new AnonymousScopeEntry [anonymous_scope_offsets.Count];
+					int i = 0;
+					foreach (int id in anonymous_scope_offsets.Keys)
+						scopes [i++] = read_scope (id);
+					return scopes;
+				}
 			}
 		}
 
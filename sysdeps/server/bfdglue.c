@@ -1,6 +1,11 @@
 #include <bfdglue.h>
 #include <signal.h>
 #include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <elf/internal.h>
 #if defined(__linux__) || defined(__FreeBSD__)
 #include <link.h>
 #include <elf.h>
@@ -14,6 +19,10 @@
 #include <sys/procfs.h>
 #endif
 
+#ifndef SHF_COMPRESSED
+#define SHF_COMPRESSED (1 << 11)
+#endif
+
 bfd *
 bfd_glue_openr (const char *filename, const char *target)
 {
@@ -65,14 +74,15 @@ bfd_glue_get_symbols (bfd *abfd, asymbol ***symbol_table)
 	return bfd_canonicalize_symtab (abfd, *symbol_table);
 }
 
-gchar *
-bfd_glue_get_symbol (bfd *abfd, asymbol **symbol_table, int idx, int *is_function, guint64 *address)
+/*
+ * Returns the symbol's name and fills in `is_function' and `address' if it's a
+ * symbol we're interested in or NULL to skip it.
+ */
+static const gchar *
+classify_symbol (asymbol *symbol, int *is_function, guint64 *address)
 {
-	asymbol *symbol;
 	int flags;
 
-	symbol = symbol_table [idx];
-
 	if ((symbol->flags & (BSF_WEAK | BSF_DYNAMIC)) == (BSF_WEAK | BSF_DYNAMIC))
 		return NULL;
 	if ((symbol->flags & BSF_DEBUGGING) || !symbol->name || !strlen (symbol->name))
@@ -108,7 +118,16 @@ bfd_glue_get_symbol (bfd *abfd, asymbol **symbol_table, int idx, int *is_functio
 		*address = symbol->section->vma + symbol->value;
 	}
 
-	return g_strdup (symbol->name);
+	return symbol->name;
+}
+
+gchar *
+bfd_glue_get_symbol (bfd *abfd, asymbol **symbol_table, int idx, int *is_function, guint64 *address)
+{
+	const gchar *name;
+
+	name = classify_symbol (symbol_table [idx], is_function, address);
+	return name ? g_strdup (name) : NULL;
 }
 
 int
@@ -126,11 +145,177 @@ bfd_glue_get_dynamic_symbols (bfd *abfd, asymbol ***symbol_table)
 	return bfd_canonicalize_dynamic_symtab (abfd, *symbol_table);
 }
 
+typedef struct {
+	guint64 address;
+	guint32 name;
+	guint32 flags;
+} SymbolInfo;
+
+typedef struct {
+	const SymbolInfo *symbols;
+	const gchar *strings;
+} SymbolSortContext;
+
+static void
+add_symbols (GArray *symbols, GString *strings, asymbol **symbol_table, int count,
+	     guint32 extra_flags, gboolean strip_underscore)
+{
+	int i;
+
+	for (i = 0; i < count; i++) {
+		const gchar *name;
+		int is_function;
+		guint64 address;
+		SymbolInfo info;
+
+		name = classify_symbol (symbol_table [i], &is_function, &address);
+		if (!name)
+			continue;
+
+		if (strip_underscore && (name [0] == '_'))
+			name++;
+
+		info.address = address;
+		info.name = strings->len;
+		info.flags = extra_flags;
+		if (is_function)
+			info.flags |= BFD_GLUE_SYMBOL_FUNCTION;
+		if (!(extra_flags & BFD_GLUE_SYMBOL_DYNAMIC) &&
+		    (is_function || !strncmp (name, "MONO_DEBUGGER__", 15)))
+			info.flags |= BFD_GLUE_SYMBOL_GLOBAL;
+
+		g_string_append_len (strings, name, strlen (name) + 1);
+		g_array_append_val (symbols, info);
+	}
+}
+
+/*
+ * Both sort functions sort an array of indices into the SymbolInfo array and
+ * use the index as tie-breaker, so symbols with the same address or name stay
+ * in symbol table order.
+ */
+static gint
+compare_symbols_by_address (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+	const SymbolInfo *symbols = user_data;
+	guint32 i = *(const guint32 *) a;
+	guint32 j = *(const guint32 *) b;
+
+	if (symbols [i].address != symbols [j].address)
+		return symbols [i].address < symbols [j].address ? -1 : 1;
+
+	return i < j ? -1 : (i > j ? 1 : 0);
+}
+
+static gint
+compare_symbols_by_name (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+	const SymbolSortContext *context = user_data;
+	guint32 i = *(const guint32 *) a;
+	guint32 j = *(const guint32 *) b;
+	int result;
+
+	result = strcmp (context->strings + context->symbols [i].name,
+			 context->strings + context->symbols [j].name);
+	if (result)
+		return result;
+
+	return i < j ? -1 : (i > j ? 1 : 0);
+}
+
+BfdGlueSymbolTable *
+bfd_glue_read_symbol_table (bfd *abfd, gboolean strip_underscore)
+{
+	BfdGlueSymbolTable *table;
+	SymbolSortContext context;
+	asymbol **symbol_table;
+	GArray *symbols;
+	GString *strings;
+	guint32 *order, *position;
+	guint32 i, count;
+	int num_symbols;
+
+	symbols = g_array_new (FALSE, FALSE, sizeof (SymbolInfo));
+	strings = g_string_new (NULL);
+
+	num_symbols = bfd_glue_get_symbols (abfd, &symbol_table);
+	if (num_symbols > 0)
+		add_symbols (symbols, strings, symbol_table, num_symbols, 0, strip_underscore);
+	g_free (symbol_table);
+
+	num_symbols = bfd_glue_get_dynamic_symbols (abfd, &symbol_table);
+	if (num_symbols > 0)
+		add_symbols (symbols, strings, symbol_table, num_symbols,
+			     BFD_GLUE_SYMBOL_DYNAMIC, FALSE);
+	g_free (symbol_table);
+
+	count = symbols->len;
+
+	table = g_new0 (BfdGlueSymbolTable, 1);
+	table->count = count;
+	table->addresses = g_new0 (guint64, count);
+	table->names = g_new0 (guint32, count);
+	table->flags = g_new0 (guint32, count);
+	table->name_order = g_new0 (guint32, count);
+
+	order = g_new0 (guint32, count);
+	position = g_new0 (guint32, count);
+
+	for (i = 0; i < count; i++)
+		order [i] = i;
+	g_qsort_with_data (order, count, sizeof (guint32), compare_symbols_by_address, symbols->data);
+
+	for (i = 0; i < count; i++) {
+		SymbolInfo *info = &g_array_index (symbols, SymbolInfo, order [i]);
+
+		table->addresses [i] = info->address;
+		table->names [i] = info->name;
+		table->flags [i] = info->flags;
+		position [order [i]] = i;
+	}
+
+	context.symbols = (const SymbolInfo *) symbols->data;
+	context.strings = strings->str;
+
+	for (i = 0; i < count; i++)
+		order [i] = i;
+	g_qsort_with_data (order, count, sizeof (guint32), compare_symbols_by_name, &context);
+
+	for (i = 0; i < count; i++)
+		table->name_order [i] = position [order [i]];
+
+	g_free (order);
+	g_free (position);
+	g_array_free (symbols, TRUE);
+
+	table->strings_size = strings->len;
+	table->strings = g_string_free (strings, FALSE);
+
+	return table;
+}
+
+void
+bfd_glue_free_symbol_table (BfdGlueSymbolTable *table)
+{
+	g_free (table->addresses);
+	g_free (table->names);
+	g_free (table->flags);
+	g_free (table->name_order);
+	g_free (table->strings);
+	g_free (table);
+}
+
 static int
 read_memory_func (bfd_vma memaddr, bfd_byte *myaddr, unsigned int length, struct disassemble_info *info)
 {
 	BfdGlueDisassemblerInfo *data = info->application_data;
 
+	if (data->code_buffer && (memaddr >= data->code_start) &&
+	    (memaddr + length <= data->code_start + data->code_size)) {
+		memcpy (myaddr, data->code_buffer + (memaddr - data->code_start), length);
+		return 0;
+	}
+
 	return (* data->read_memory_cb) (memaddr, myaddr, length);
 }
 
@@ -146,7 +331,10 @@ fprintf_func (gpointer stream, const char *message, ...)
 	output = g_strdup_vprintf (message, args);
 	va_end (args);
 
-	data->output_cb (output);
+	if (data->output)
+		g_string_append (data->output, output);
+	else
+		data->output_cb (output);
 	retval = strlen (output);
 	g_free (output);
 
@@ -207,12 +395,169 @@ bfd_glue_disassemble_insn (BfdGlueDisassemblerInfo *handle, guint64 address)
 	return handle->disassembler (address, handle->info);
 }
 
+int
+bfd_glue_disassemble_insn_buffered (BfdGlueDisassemblerInfo *handle, guint64 address,
+				    const guint8 *code, guint32 code_size)
+{
+	int retval;
+
+	handle->code_buffer = code;
+	handle->code_start = address;
+	handle->code_size = code_size;
+
+	retval = handle->disassembler (address, handle->info);
+
+	handle->code_buffer = NULL;
+	return retval;
+}
+
+void
+bfd_glue_append_output (BfdGlueDisassemblerInfo *handle, const char *output)
+{
+	if (handle->output)
+		g_string_append (handle->output, output);
+	else
+		handle->output_cb (output);
+}
+
+/*
+ * Disassemble all the instructions in `code', which has been read from
+ * `start' in the target.  Returns the number of instructions; `*data' is a
+ * newly allocated buffer of `*size' bytes containing one record for each of
+ * them:
+ *
+ *	guint32 offset;		offset of the instruction in `code'
+ *	guint32 length;		size of the instruction
+ *	guint32 text_length;	size of the disassembly in bytes
+ *	char text [];		disassembly, zero-terminated
+ */
+int
+bfd_glue_disassemble_buffer (BfdGlueDisassemblerInfo *handle, guint64 start,
+			     const guint8 *code, guint32 code_size, guint32 *size, gpointer *data)
+{
+	GByteArray *records;
+	guint32 offset = 0;
+	int count = 0;
+
+	records = g_byte_array_new ();
+
+	handle->code_buffer = code;
+	handle->code_start = start;
+	handle->code_size = code_size;
+
+	while (offset < code_size) {
+		guint32 header [3];
+		int length;
+
+		handle->output = g_string_new (NULL);
+		length = handle->disassembler (start + offset, handle->info);
+		if (length <= 0) {
+			g_string_free (handle->output, TRUE);
+			handle->output = NULL;
+			break;
+		}
+
+		header [0] = offset;
+		header [1] = length;
+		header [2] = handle->output->len;
+		g_byte_array_append (records, (const guint8 *) header, sizeof (header));
+		g_byte_array_append (records, (const guint8 *) handle->output->str,
+				     handle->output->len + 1);
+
+		g_string_free (handle->output, TRUE);
+		handle->output = NULL;
+
+		offset += length;
+		count++;
+	}
+
+	handle->code_buffer = NULL;
+
+	*size = records->len;
+	*data = g_byte_array_free (records, FALSE);
+	return count;
+}
+
 gboolean
 bfd_glue_get_section_contents (bfd *abfd, asection *section, gpointer data, guint32 size)
 {
 	return bfd_get_section_contents (abfd, section, data, 0, size);
 }
 
+/*
+ * Check whether the contents of `section' are stored verbatim in the file,
+ * so they can be mapped into memory instead of being copied.
+ *
+ * Compressed debugging sections (`.zdebug_*' or SHF_COMPRESSED) are not:
+ * the file only contains the compressed bytes.
+ */
+gboolean
+bfd_glue_get_section_file_range (bfd *abfd, asection *section, guint64 *offset, guint32 *size)
+{
+	if (abfd->my_archive || (abfd->flags & BFD_IN_MEMORY))
+		return FALSE;
+	if (!(section->flags & SEC_HAS_CONTENTS) || (section->flags & SEC_RELOC))
+		return FALSE;
+	if (!strncmp (bfd_get_section_name (abfd, section), ".zdebug", 7))
+		return FALSE;
+
+	/*
+	 * `used_by_bfd' is a `struct bfd_elf_section_data', which starts
+	 * with the section header.
+	 */
+	if ((bfd_get_flavour (abfd) == bfd_target_elf_flavour) && section->used_by_bfd) {
+		Elf_Internal_Shdr *hdr = (Elf_Internal_Shdr *) section->used_by_bfd;
+
+		if (hdr->sh_flags & SHF_COMPRESSED)
+			return FALSE;
+	}
+
+	*offset = section->filepos + abfd->origin;
+	*size = bfd_section_size (abfd, section);
+	return TRUE;
+}
+
+gpointer
+bfd_glue_map_file (const char *filename, guint64 *size)
+{
+	struct stat st;
+	gpointer address;
+	int fd;
+
+	/*
+	 * Reading from a mapping raises SIGBUS once the file is truncated, so
+	 * don't map files we could be rebuilding while they're being debugged.
+	 * Installed libraries are normally replaced with rename(), which
+	 * leaves our mapping of the old file intact.
+	 */
+	if (!access (filename, W_OK))
+		return NULL;
+
+	fd = open (filename, O_RDONLY);
+	if (fd < 0)
+		return NULL;
+
+	if ((fstat (fd, &st) < 0) || !st.st_size) {
+		close (fd);
+		return NULL;
+	}
+
+	address = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close (fd);
+
+	if (address == MAP_FAILED)
+		return NULL;
+
+	*size = st.st_size;
+	return address;
+}
+
+void
+bfd_glue_unmap_file (gpointer address, guint64 size)
+{
+	munmap (address, size);
+}
+
 asection *
 bfd_glue_get_first_section (bfd *abfd)
 {
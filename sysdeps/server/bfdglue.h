@@ -25,6 +25,35 @@ bfd_glue_get_symbol (bfd *abfd, asymbol **symbol_table, int idx, int *is_functio
 extern int
 bfd_glue_get_dynamic_symbols (bfd *abfd, asymbol ***symbol_table);
 
+typedef enum {
+	BFD_GLUE_SYMBOL_FUNCTION	= 1,
+	BFD_GLUE_SYMBOL_DYNAMIC		= 2,
+	/* Static function or MONO_DEBUGGER__ symbol, see Bfd.LookupSymbol(). */
+	BFD_GLUE_SYMBOL_GLOBAL		= 4
+} BfdGlueSymbolFlags;
+
+/*
+ * The static and dynamic symbol tables, packed into flat arrays.
+ *
+ * `addresses', `names' (offsets into `strings') and `flags' are sorted by
+ * address; `name_order' contains indices into these, sorted by name.
+ */
+typedef struct {
+	guint32 count;
+	guint32 strings_size;
+	guint64 *addresses;
+	guint32 *names;
+	guint32 *flags;
+	guint32 *name_order;
+	gchar *strings;
+} BfdGlueSymbolTable;
+
+extern BfdGlueSymbolTable *
+bfd_glue_read_symbol_table (bfd *abfd, gboolean strip_underscore);
+
+extern void
+bfd_glue_free_symbol_table (BfdGlueSymbolTable *table);
+
 typedef int (*BfdGlueReadMemoryHandler) (guint64 address, bfd_byte *buffer, int size);
 typedef void (*BfdGlueOutputHandler) (const char *output);
 typedef void (*BfdGluePrintAddressHandler) (guint64 address);
@@ -35,6 +64,20 @@ typedef struct {
 	BfdGlueOutputHandler output_cb;
 	BfdGluePrintAddressHandler print_address_cb;
 	disassembler_ftype disassembler;
+
+	/*
+	 * Prefetched code: reads which are entirely inside this buffer don't
+	 * call `read_memory_cb'.
+	 */
+	const guint8 *code_buffer;
+	guint64 code_start;
+	guint32 code_size;
+
+	/*
+	 * While disassembling a whole buffer, the output is collected here instead
+	 * of being sent to `output_cb'.
+	 */
+	GString *output;
 } BfdGlueDisassemblerInfo;
 
 extern BfdGlueDisassemblerInfo *
@@ -49,6 +92,17 @@ bfd_glue_free_disassembler (BfdGlueDisassemblerInfo *handle);
 extern int
 bfd_glue_disassemble_insn (BfdGlueDisassemblerInfo *handle, guint64 address);
 
+extern int
+bfd_glue_disassemble_insn_buffered (BfdGlueDisassemblerInfo *handle, guint64 address,
+				    const guint8 *code, guint32 code_size);
+
+extern int
+bfd_glue_disassemble_buffer (BfdGlueDisassemblerInfo *handle, guint64 start,
+			     const guint8 *code, guint32 code_size, guint32 *size, gpointer *data);
+
+extern void
+bfd_glue_append_output (BfdGlueDisassemblerInfo *handle, const char *output);
+
 typedef enum {
 	SECTION_FLAGS_LOAD	= 1,
 	SECTION_FLAGS_ALLOC	= 2,
@@ -64,6 +118,15 @@ bfd_glue_get_errormsg (void);
 extern gboolean
 bfd_glue_get_section_contents (bfd *abfd, asection *section, gpointer data, guint32 size);
 
+extern gboolean
+bfd_glue_get_section_file_range (bfd *abfd, asection *section, guint64 *offset, guint32 *size);
+
+extern gpointer
+bfd_glue_map_file (const char *filename, guint64 *size);
+
+extern void
+bfd_glue_unmap_file (gpointer address, guint64 size);
+
 extern guint64
 bfd_glue_get_section_vma (asection *p);
 
@@ -0,0 +1,133 @@
+/*
+ * Microbenchmark for the breakpoint address index.
+ *
+ * Measures the cost of removing breakpoints from a block of target memory
+ * (what every memory read in the server does) against the number of inserted
+ * breakpoints, comparing a linear scan over all breakpoints with a range query
+ * on the address index.
+ *
+ * Build with `make breakpoint-bench' and run it without arguments.
+ */
+
+#include <server.h>
+#include <breakpoints.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEXT_START	0x400000
+#define TEXT_SIZE	(64 * 1024 * 1024)
+#define READ_SIZE	4096
+#define ITERATIONS	20000
+
+static void
+remove_breakpoints_linear (BreakpointManager *bpm, guint64 start, guint32 size, guint8 *ptr)
+{
+	GPtrArray *breakpoints;
+	int i;
+
+	mono_debugger_breakpoint_manager_lock ();
+
+	breakpoints = mono_debugger_breakpoint_manager_get_breakpoints (bpm);
+	for (i = 0; i < breakpoints->len; i++) {
+		BreakpointInfo *info = g_ptr_array_index (breakpoints, i);
+
+		if (info->is_hardware_bpt || !info->enabled)
+			continue;
+		if ((info->address < start) || (info->address >= start+size))
+			continue;
+
+		ptr [info->address - start] = info->saved_insn;
+	}
+
+	mono_debugger_breakpoint_manager_unlock ();
+}
+
+static void
+remove_breakpoints_indexed (BreakpointManager *bpm, guint64 start, guint32 size, guint8 *ptr)
+{
+	const BreakpointIndex *index;
+	guint32 i;
+
+	index = mono_debugger_breakpoint_manager_begin_read (bpm);
+	for (i = mono_debugger_breakpoint_index_lower_bound (index, start); i < index->count; i++) {
+		BreakpointInfo *info = index->entries [i];
+
+		if (info->address >= start+size)
+			break;
+		if (info->is_hardware_bpt || !g_atomic_int_get (&info->enabled))
+			continue;
+
+		ptr [info->address - start] = info->saved_insn;
+	}
+	mono_debugger_breakpoint_manager_end_read (bpm);
+}
+
+static double
+run (BreakpointManager *bpm, guint64 *addresses,
+     void (* func) (BreakpointManager *, guint64, guint32, guint8 *))
+{
+	guint8 buffer [READ_SIZE];
+	GTimer *timer;
+	double elapsed;
+	int i;
+
+	timer = g_timer_new ();
+	for (i = 0; i < ITERATIONS; i++)
+		func (bpm, addresses [i], READ_SIZE, buffer);
+	elapsed = g_timer_elapsed (timer, NULL);
+	g_timer_destroy (timer);
+
+	return elapsed * 1e9 / ITERATIONS;
+}
+
+int
+main (int argc, char *argv [])
+{
+	static const int counts [] = { 0, 16, 256, 1024, 4096, 16384 };
+	guint64 *addresses;
+	int i, j;
+
+	g_thread_init (NULL);
+
+	addresses = g_new0 (guint64, ITERATIONS);
+	for (i = 0; i < ITERATIONS; i++)
+		addresses [i] = TEXT_START + g_random_int_range (0, TEXT_SIZE - READ_SIZE);
+
+	printf ("%12s %16s %16s\n", "breakpoints", "linear (ns/read)", "indexed (ns/read)");
+
+	for (i = 0; i < G_N_ELEMENTS (counts); i++) {
+		BreakpointManager *bpm = mono_debugger_breakpoint_manager_new ();
+		double linear, indexed;
+
+		mono_debugger_breakpoint_manager_lock ();
+		for (j = 0; j < counts [i]; j++) {
+			BreakpointInfo *info = g_new0 (BreakpointInfo, 1);
+
+			info->id = mono_debugger_breakpoint_manager_get_next_id ();
+			info->refcount = 1;
+			info->enabled = TRUE;
+			info->dr_index = -1;
+			info->saved_insn = (char) 0x90;
+			info->address = TEXT_START + g_random_int_range (0, TEXT_SIZE);
+
+			if (mono_debugger_breakpoint_manager_lookup (bpm, info->address)) {
+				g_free (info);
+				continue;
+			}
+
+			mono_debugger_breakpoint_manager_insert (bpm, info);
+		}
+		mono_debugger_breakpoint_manager_unlock ();
+
+		linear = run (bpm, addresses, remove_breakpoints_linear);
+		indexed = run (bpm, addresses, remove_breakpoints_indexed);
+
+		printf ("%12d %16.1f %16.1f\n", counts [i], linear, indexed);
+
+		mono_debugger_breakpoint_manager_free (bpm);
+	}
+
+	g_free (addresses);
+	return 0;
+}
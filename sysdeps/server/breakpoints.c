@@ -6,6 +6,7 @@
 #ifdef HAVE_UNISTD_H
 #include <unistd.h>
 #endif
+#include <stdlib.h>
 #include <string.h>
 #include <fcntl.h>
 #include <errno.h>
@@ -14,6 +15,113 @@ static GStaticRecMutex bpm_mutex = G_STATIC_REC_MUTEX_INIT;
 
 static int last_breakpoint_id = 0;
 
+/*
+ * The address index.
+ *
+ * Reading the target's memory needs to find all the breakpoints in a range of
+ * addresses, so we keep an address-sorted array of them in addition to the
+ * hash tables.  This array is never modified: inserting or removing a
+ * breakpoint (which is always done while holding the `bpm_mutex') creates a
+ * new copy and atomically replaces the old one.
+ *
+ * Readers don't take the lock; they just announce themselves in `bpm->readers'
+ * while they're using the index.  Old indices and removed breakpoints are put
+ * on the `retired' list and only freed once there are no more readers.
+ *
+ * A reader uses a breakpoint's `saved_insn' only if it sees it as `enabled', so
+ * both are published in this order (with g_atomic_int_set(), which is a full
+ * memory barrier, and read back with g_atomic_int_get()):
+ *
+ *  - a new breakpoint is added to the index before it's enabled,
+ *  - enabling sets `saved_insn', then `enabled', then writes the breakpoint
+ *    instruction into the target's memory,
+ *  - disabling restores the original instruction before clearing `enabled',
+ *  - a breakpoint is only removed from the index after it's been disabled.
+ *
+ * This way, a reader which finds the breakpoint instruction in memory always
+ * sees the breakpoint as enabled, with the correct `saved_insn'.  The other way
+ * round is harmless: if the breakpoint is enabled, but the instruction isn't
+ * written yet (or already restored), replacing it with `saved_insn' is a no-op.
+ */
+
+static BreakpointIndex *
+breakpoint_index_new (guint32 count)
+{
+	BreakpointIndex *index;
+
+	index = g_malloc (sizeof (BreakpointIndex) + count * sizeof (BreakpointInfo *));
+	index->count = count;
+	return index;
+}
+
+static void
+collect_retired (BreakpointManager *bpm)
+{
+	GSList *l;
+
+	if (g_atomic_int_get (&bpm->readers) != 0)
+		return;
+
+	for (l = bpm->retired; l; l = l->next)
+		g_free (l->data);
+	g_slist_free (bpm->retired);
+	bpm->retired = NULL;
+}
+
+static void
+publish_index (BreakpointManager *bpm, BreakpointIndex *index)
+{
+	BreakpointIndex *old = bpm->index;
+
+	g_atomic_pointer_set ((volatile gpointer *) &bpm->index, index);
+	bpm->retired = g_slist_prepend (bpm->retired, old);
+
+	collect_retired (bpm);
+}
+
+static int
+compare_breakpoints (gconstpointer a, gconstpointer b)
+{
+	const BreakpointInfo *info_a = *(const BreakpointInfo **) a;
+	const BreakpointInfo *info_b = *(const BreakpointInfo **) b;
+
+	if (info_a->address < info_b->address)
+		return -1;
+	else if (info_a->address > info_b->address)
+		return 1;
+	return 0;
+}
+
+guint32
+mono_debugger_breakpoint_index_lower_bound (const BreakpointIndex *index, guint64 address)
+{
+	guint32 low = 0, high = index->count;
+
+	while (low < high) {
+		guint32 mid = low + (high - low) / 2;
+
+		if (index->entries [mid]->address < address)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	return low;
+}
+
+const BreakpointIndex *
+mono_debugger_breakpoint_manager_begin_read (BreakpointManager *bpm)
+{
+	g_atomic_int_inc (&bpm->readers);
+	return g_atomic_pointer_get ((volatile gpointer *) &bpm->index);
+}
+
+void
+mono_debugger_breakpoint_manager_end_read (BreakpointManager *bpm)
+{
+	g_atomic_int_add (&bpm->readers, -1);
+}
+
 BreakpointManager *
 mono_debugger_breakpoint_manager_new (void)
 {
@@ -22,6 +130,7 @@ mono_debugger_breakpoint_manager_new (void)
 	bpm->breakpoints = g_ptr_array_new ();
 	bpm->breakpoint_hash = g_hash_table_new (NULL, NULL);
 	bpm->breakpoint_by_addr = g_hash_table_new (NULL, NULL);
+	bpm->index = breakpoint_index_new (0);
 
 	return bpm;
 }
@@ -30,15 +139,24 @@ BreakpointManager *
 mono_debugger_breakpoint_manager_clone (BreakpointManager *old)
 {
 	BreakpointManager *bpm = mono_debugger_breakpoint_manager_new ();
+	BreakpointIndex *index;
 	int i;
 
+	index = breakpoint_index_new (old->breakpoints->len);
+
 	for (i = 0; i < old->breakpoints->len; i++) {
 		BreakpointInfo *old_info = g_ptr_array_index (old->breakpoints, i);
 		BreakpointInfo *info = g_memdup (old_info, sizeof (BreakpointInfo));
 
-		mono_debugger_breakpoint_manager_insert (bpm, info);
+		g_ptr_array_add (bpm->breakpoints, info);
+		g_hash_table_insert (bpm->breakpoint_hash, GSIZE_TO_POINTER (info->id), info);
+		g_hash_table_insert (bpm->breakpoint_by_addr, GSIZE_TO_POINTER (info->address), info);
+		index->entries [i] = info;
 	}
 
+	qsort (index->entries, index->count, sizeof (BreakpointInfo *), compare_breakpoints);
+	publish_index (bpm, index);
+
 	return bpm;
 }
 
@@ -48,6 +166,9 @@ mono_debugger_breakpoint_manager_free (BreakpointManager *bpm)
 	g_ptr_array_free (bpm->breakpoints, TRUE);
 	g_hash_table_destroy (bpm->breakpoint_hash);
 	g_hash_table_destroy (bpm->breakpoint_by_addr);
+	g_slist_foreach (bpm->retired, (GFunc) g_free, NULL);
+	g_slist_free (bpm->retired);
+	g_free (bpm->index);
 	g_free (bpm);
 }
 
@@ -66,9 +187,23 @@ mono_debugger_breakpoint_manager_unlock (void)
 void
 mono_debugger_breakpoint_manager_insert (BreakpointManager *bpm, BreakpointInfo *breakpoint)
 {
+	BreakpointIndex *old_index, *index;
+	guint32 pos;
+
 	g_ptr_array_add (bpm->breakpoints, breakpoint);
 	g_hash_table_insert (bpm->breakpoint_hash, GSIZE_TO_POINTER (breakpoint->id), breakpoint);
 	g_hash_table_insert (bpm->breakpoint_by_addr, GSIZE_TO_POINTER (breakpoint->address), breakpoint);
+
+	old_index = bpm->index;
+	pos = mono_debugger_breakpoint_index_lower_bound (old_index, breakpoint->address);
+
+	index = breakpoint_index_new (old_index->count + 1);
+	memcpy (index->entries, old_index->entries, pos * sizeof (BreakpointInfo *));
+	index->entries [pos] = breakpoint;
+	memcpy (index->entries + pos + 1, old_index->entries + pos,
+		(old_index->count - pos) * sizeof (BreakpointInfo *));
+
+	publish_index (bpm, index);
 }
 
 BreakpointInfo *
@@ -92,6 +227,9 @@ mono_debugger_breakpoint_manager_get_breakpoints (BreakpointManager *bpm)
 void
 mono_debugger_breakpoint_manager_remove (BreakpointManager *bpm, BreakpointInfo *breakpoint)
 {
+	BreakpointIndex *old_index, *index;
+	guint32 pos;
+
 	if (!mono_debugger_breakpoint_manager_lookup_by_id (bpm, breakpoint->id)) {
 		g_warning (G_STRLOC ": mono_debugger_breakpoint_manager_remove(): No such breakpoint %d", breakpoint->id);
 		return;
@@ -103,7 +241,23 @@ mono_debugger_breakpoint_manager_remove (BreakpointManager *bpm, BreakpointInfo
 	g_hash_table_remove (bpm->breakpoint_hash, GSIZE_TO_POINTER (breakpoint->id));
 	g_hash_table_remove (bpm->breakpoint_by_addr, GSIZE_TO_POINTER (breakpoint->address));
 	g_ptr_array_remove_fast (bpm->breakpoints, breakpoint);
-	g_free (breakpoint);
+
+	old_index = bpm->index;
+	pos = mono_debugger_breakpoint_index_lower_bound (old_index, breakpoint->address);
+	while ((pos < old_index->count) && (old_index->entries [pos] != breakpoint))
+		pos++;
+	g_assert (pos < old_index->count);
+
+	index = breakpoint_index_new (old_index->count - 1);
+	memcpy (index->entries, old_index->entries, pos * sizeof (BreakpointInfo *));
+	memcpy (index->entries + pos, old_index->entries + pos + 1,
+		(old_index->count - pos - 1) * sizeof (BreakpointInfo *));
+
+	/*
+	 * Readers may still be looking at the breakpoint through the old index.
+	 */
+	bpm->retired = g_slist_prepend (bpm->retired, breakpoint);
+	publish_index (bpm, index);
 }
 
 int
@@ -121,5 +275,5 @@ mono_debugger_breakpoint_info_get_id (BreakpointInfo *info)
 gboolean
 mono_debugger_breakpoint_info_get_is_enabled (BreakpointInfo *info)
 {
-	return info->enabled;
+	return g_atomic_int_get (&info->enabled);
 }
@@ -5,10 +5,20 @@
 
 G_BEGIN_DECLS
 
+typedef struct _BreakpointIndex BreakpointIndex;
+
 typedef struct {
 	GPtrArray *breakpoints;
 	GHashTable *breakpoint_hash;
 	GHashTable *breakpoint_by_addr;
+
+	/*
+	 * Address-ordered index of all breakpoints; see
+	 * mono_debugger_breakpoint_manager_begin_read().
+	 */
+	BreakpointIndex *index;
+	GSList *retired;
+	volatile gint readers;
 } BreakpointManager;
 
 typedef enum {
@@ -22,7 +32,8 @@ typedef struct {
 	HardwareBreakpointType type;
 	int id;
 	int refcount;
-	int enabled;
+	/* Read by the lock-free readers of the address index; see breakpoints.c. */
+	volatile gint enabled;
 	int is_hardware_bpt;
 	int dr_index;
 	char saved_insn;
@@ -30,6 +41,14 @@ typedef struct {
 	guint64 address;
 } BreakpointInfo;
 
+/*
+ * An immutable snapshot of all the breakpoints, sorted by address.
+ */
+struct _BreakpointIndex {
+	guint32 count;
+	BreakpointInfo *entries [1];
+};
+
 BreakpointManager *
 mono_debugger_breakpoint_manager_new                 (void);
 
@@ -63,6 +82,15 @@ mono_debugger_breakpoint_manager_get_breakpoints     (BreakpointManager *bpm);
 void
 mono_debugger_breakpoint_manager_remove              (BreakpointManager *bpm, BreakpointInfo *breakpoint);
 
+const BreakpointIndex *
+mono_debugger_breakpoint_manager_begin_read          (BreakpointManager *bpm);
+
+void
+mono_debugger_breakpoint_manager_end_read            (BreakpointManager *bpm);
+
+guint32
+mono_debugger_breakpoint_index_lower_bound           (const BreakpointIndex *index, guint64 address);
+
 int
 mono_debugger_breakpoint_info_get_id                 (BreakpointInfo *info);
 
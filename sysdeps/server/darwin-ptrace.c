@@ -280,8 +280,8 @@ struct vm_region_list
 };
 
 static ServerCommandError
-server_ptrace_write_memory (ServerHandle *handle, guint64 start,
-			    guint32 size, gconstpointer buffer)
+_server_ptrace_write_memory (ServerHandle *handle, guint64 start,
+			     guint32 size, gconstpointer buffer)
 {
 	kern_return_t err;
 	vm_address_t low_address = (vm_address_t) trunc_page (start);
@@ -522,6 +522,17 @@ server_ptrace_global_wait (guint32 *status_ret)
 	return ret;
 }
 
+static guint32
+server_ptrace_global_wait_nohang (guint32 *status_ret)
+{
+	/*
+	 * Not supported; the engine just waits for the next event with
+	 * server_ptrace_global_wait().
+	 */
+	*status_ret = 0;
+	return 0;
+}
+
 static ServerCommandError
 server_ptrace_stop (ServerHandle *handle)
 {
@@ -572,6 +583,21 @@ server_ptrace_stop_and_wait (ServerHandle *handle, guint32 *status)
 	return server_ptrace_stop (handle);
 }
 
+static ServerCommandError
+server_ptrace_stop_and_wait_group (ServerHandle **handles, guint32 count,
+				   guint32 *statuses, ServerCommandError *results)
+{
+	guint32 i;
+
+	/*
+	 * We don't wait for the individual threads anyways.
+	 */
+	for (i = 0; i < count; i++)
+		results [i] = server_ptrace_stop_and_wait (handles [i], &statuses [i]);
+
+	return COMMAND_ERROR_NONE;
+}
+
 thread_t
 get_application_thread_port (mach_port_t task, thread_t our_name)
 {
@@ -86,27 +86,68 @@ void
 x86_arch_remove_breakpoints_from_target_memory (ServerHandle *handle, guint64 start,
 						guint32 size, gpointer buffer)
 {
-	GPtrArray *breakpoints;
+	const BreakpointIndex *index;
 	guint8 *ptr = buffer;
-	int i;
+	guint32 i;
+
+	/*
+	 * This is called for every single memory read, so we use the address
+	 * index here and don't take the breakpoint manager lock.
+	 */
+	index = mono_debugger_breakpoint_manager_begin_read (handle->bpm);
+	for (i = mono_debugger_breakpoint_index_lower_bound (index, start); i < index->count; i++) {
+		BreakpointInfo *info = index->entries [i];
+		guint32 offset;
+
+		if (info->address >= start+size)
+			break;
+		if (info->is_hardware_bpt || !g_atomic_int_get (&info->enabled))
+			continue;
+
+		offset = (guint32) info->address - start;
+		ptr [offset] = info->saved_insn;
+	}
+	mono_debugger_breakpoint_manager_end_read (handle->bpm);
+}
+
+gpointer
+x86_arch_insert_breakpoints_into_target_memory (ServerHandle *handle, guint64 start,
+						guint32 size, gconstpointer buffer)
+{
+	const BreakpointIndex *index;
+	guint8 *copy = NULL;
+	guint32 i;
 
 	mono_debugger_breakpoint_manager_lock ();
 
-	breakpoints = mono_debugger_breakpoint_manager_get_breakpoints (handle->bpm);
-	for (i = 0; i < breakpoints->len; i++) {
-		BreakpointInfo *info = g_ptr_array_index (breakpoints, i);
+	index = mono_debugger_breakpoint_manager_begin_read (handle->bpm);
+	for (i = mono_debugger_breakpoint_index_lower_bound (index, start); i < index->count; i++) {
+		BreakpointInfo *info = index->entries [i];
 		guint32 offset;
 
+		if (info->address >= start+size)
+			break;
 		if (info->is_hardware_bpt || !info->enabled)
 			continue;
-		if ((info->address < start) || (info->address >= start+size))
-			continue;
+
+		if (!copy)
+			copy = g_memdup (buffer, size);
 
 		offset = (guint32) info->address - start;
-		ptr [offset] = info->saved_insn;
+		info->saved_insn = copy [offset];
+		copy [offset] = 0xcc;
+
+		if (handle->mono_runtime) {
+			guint64 table_address = handle->mono_runtime->breakpoint_info_area +
+				8 * info->runtime_table_slot;
+
+			server_ptrace_poke_word (handle, table_address + 4, (gsize) info->saved_insn);
+		}
 	}
+	mono_debugger_breakpoint_manager_end_read (handle->bpm);
 
 	mono_debugger_breakpoint_manager_unlock ();
+	return copy;
 }
 
 static ServerCommandError
@@ -939,9 +980,17 @@ x86_arch_enable_breakpoint (ServerHandle *handle, BreakpointInfo *breakpoint)
 				return result;
 		}
 
-		result = server_ptrace_write_memory (handle, address, 1, &bopcode);
-		if (result != COMMAND_ERROR_NONE)
+		/*
+		 * Readers must see the breakpoint as enabled before the breakpoint
+		 * instruction is in memory; see the comment in breakpoints.c.
+		 */
+		g_atomic_int_set (&breakpoint->enabled, TRUE);
+
+		result = _server_ptrace_write_memory (handle, address, 1, &bopcode);
+		if (result != COMMAND_ERROR_NONE) {
+			g_atomic_int_set (&breakpoint->enabled, FALSE);
 			return result;
+		}
 	}
 
 	return COMMAND_ERROR_NONE;
@@ -977,7 +1026,7 @@ x86_arch_disable_breakpoint (ServerHandle *handle, BreakpointInfo *breakpoint)
 
 		arch->dr_regs [breakpoint->dr_index] = 0;
 	} else {
-		result = server_ptrace_write_memory (handle, address, 1, &breakpoint->saved_insn);
+		result = _server_ptrace_write_memory (handle, address, 1, &breakpoint->saved_insn);
 		if (result != COMMAND_ERROR_NONE)
 			return result;
 
@@ -1012,15 +1061,21 @@ server_ptrace_insert_breakpoint (ServerHandle *handle, guint64 address, guint32
 	breakpoint->id = mono_debugger_breakpoint_manager_get_next_id ();
 	breakpoint->dr_index = -1;
 
+	/*
+	 * Add it to the address index before writing the breakpoint instruction, so the
+	 * lock-free readers know about it as soon as it's in memory.
+	 */
+	mono_debugger_breakpoint_manager_insert (handle->bpm, (BreakpointInfo *) breakpoint);
+
 	result = x86_arch_enable_breakpoint (handle, breakpoint);
 	if (result != COMMAND_ERROR_NONE) {
+		/* This also frees it once there are no more readers. */
+		mono_debugger_breakpoint_manager_remove (handle->bpm, breakpoint);
 		mono_debugger_breakpoint_manager_unlock ();
-		g_free (breakpoint);
 		return result;
 	}
 
-	breakpoint->enabled = TRUE;
-	mono_debugger_breakpoint_manager_insert (handle->bpm, (BreakpointInfo *) breakpoint);
+	g_atomic_int_set (&breakpoint->enabled, TRUE);
  done:
 	*bhandle = breakpoint->id;
 	mono_debugger_breakpoint_manager_unlock ();
@@ -1051,7 +1106,7 @@ server_ptrace_remove_breakpoint (ServerHandle *handle, guint32 idx)
 	if (result != COMMAND_ERROR_NONE)
 		goto out;
 
-	breakpoint->enabled = FALSE;
+	g_atomic_int_set (&breakpoint->enabled, FALSE);
 	mono_debugger_breakpoint_manager_remove (bpm, breakpoint);
 
  out:
@@ -1143,7 +1198,7 @@ server_ptrace_enable_breakpoint (ServerHandle *handle, guint32 idx)
 	}
 
 	result = x86_arch_enable_breakpoint (handle, breakpoint);
-	breakpoint->enabled = TRUE;
+	g_atomic_int_set (&breakpoint->enabled, TRUE);
 	mono_debugger_breakpoint_manager_unlock ();
 	return result;
 }
@@ -1162,7 +1217,7 @@ server_ptrace_disable_breakpoint (ServerHandle *handle, guint32 idx)
 	}
 
 	result = x86_arch_disable_breakpoint (handle, breakpoint);
-	breakpoint->enabled = FALSE;
+	g_atomic_int_set (&breakpoint->enabled, FALSE);
 	mono_debugger_breakpoint_manager_unlock ();
 	return result;
 }
@@ -1217,7 +1272,7 @@ find_code_buffer_slot (MonoRuntimeInfo *runtime)
 
 static ServerCommandError
 server_ptrace_execute_instruction (ServerHandle *handle, const guint8 *instruction,
-				   guint32 size, gboolean update_ip)
+				   guint32 size, gboolean update_ip, gint32 displacement_offset)
 {
 	MonoRuntimeInfo *runtime;
 	ServerCommandError result;
@@ -1228,6 +1283,10 @@ server_ptrace_execute_instruction (ServerHandle *handle, const guint8 *instructi
 	runtime = handle->mono_runtime;
 	g_assert (runtime);
 
+	/* There is no %eip-relative addressing on i386. */
+	if (displacement_offset >= 0)
+		return COMMAND_ERROR_NOT_IMPLEMENTED;
+
 	if (!runtime->executable_code_buffer)
 		return COMMAND_ERROR_INTERNAL_ERROR;
 
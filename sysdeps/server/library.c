@@ -19,6 +19,9 @@ static InferiorVTable *global_vtable = &i386_windows_inferior;
 #else
 extern InferiorVTable i386_ptrace_inferior;
 static InferiorVTable *global_vtable = &i386_ptrace_inferior;
+#ifdef __linux__
+extern InferiorVTable x86_linux_seize_inferior;
+#endif
 #endif
 
 ServerHandle *
@@ -105,6 +108,15 @@ mono_debugger_server_finalize (ServerHandle *handle)
 void
 mono_debugger_server_global_init (void)
 {
+#if defined(__linux__) && !defined(__POWERPC__)
+	/*
+	 * The PTRACE_SEIZE based backend is still experimental, so it must be
+	 * enabled explicitly.
+	 */
+	if (g_getenv ("MDB_PTRACE_SEIZE"))
+		global_vtable = &x86_linux_seize_inferior;
+#endif
+
 	(* global_vtable->global_init) ();
 }
 
@@ -114,6 +126,15 @@ mono_debugger_server_global_wait (guint32 *status)
 	return (* global_vtable->global_wait) (status);
 }
 
+guint32
+mono_debugger_server_global_wait_nohang (guint32 *status)
+{
+	if (!global_vtable->global_wait_nohang)
+		return 0;
+
+	return (* global_vtable->global_wait_nohang) (status);
+}
+
 ServerStatusMessageType
 mono_debugger_server_dispatch_event (ServerHandle *handle, guint32 status, guint64 *arg,
 				     guint64 *data1, guint64 *data2, guint32 *opt_data_size,
@@ -212,6 +233,16 @@ mono_debugger_server_read_memory (ServerHandle *handle, guint64 start, guint32 s
 	return (* global_vtable->read_memory) (handle, start, size, data);
 }
 
+ServerCommandError
+mono_debugger_server_read_string (ServerHandle *handle, guint64 start, guint32 char_size,
+				  guint32 max_length, guint32 *length, gpointer *data)
+{
+	if (!global_vtable->read_string)
+		return COMMAND_ERROR_NOT_IMPLEMENTED;
+
+	return (* global_vtable->read_string) (handle, start, char_size, max_length, length, data);
+}
+
 ServerCommandError
 mono_debugger_server_write_memory (ServerHandle *handle, guint64 start, guint32 size, gconstpointer data)
 {
@@ -291,13 +322,14 @@ mono_debugger_server_call_method_invoke (ServerHandle *handle, guint64 invoke_me
 
 ServerCommandError
 mono_debugger_server_execute_instruction (ServerHandle *handle, const guint8 *instruction,
-					  guint32 insn_size, gboolean update_ip)
+					  guint32 insn_size, gboolean update_ip,
+					  gint32 displacement_offset)
 {
 	if (!global_vtable->execute_instruction)
 		return COMMAND_ERROR_NOT_IMPLEMENTED;
 
 	return (* global_vtable->execute_instruction) (
-		handle, instruction, insn_size, update_ip);
+		handle, instruction, insn_size, update_ip, displacement_offset);
 }
 
 ServerCommandError
@@ -401,6 +433,16 @@ mono_debugger_server_stop_and_wait (ServerHandle *handle, guint32 *status)
 	return (* global_vtable->stop_and_wait) (handle, status);
 }
 
+ServerCommandError
+mono_debugger_server_stop_and_wait_group (ServerHandle **handles, guint32 count,
+					  guint32 *statuses, ServerCommandError *results)
+{
+	if (!global_vtable->stop_and_wait_group)
+		return COMMAND_ERROR_NOT_IMPLEMENTED;
+
+	return (* global_vtable->stop_and_wait_group) (handles, count, statuses, results);
+}
+
 ServerCommandError
 mono_debugger_server_set_signal (ServerHandle *handle, guint32 sig, guint32 send_it)
 {
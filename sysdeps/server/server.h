@@ -109,7 +109,8 @@ typedef enum {
 	SERVER_TYPE_UNKNOWN			= 0,
 	SERVER_TYPE_LINUX_PTRACE		= 1,
 	SERVER_TYPE_DARWIN			= 2,
-	SERVER_TYPE_WIN32			= 3
+	SERVER_TYPE_WIN32			= 3,
+	SERVER_TYPE_LINUX_SEIZE			= 4
 } ServerType;
 
 /* This is an opaque data structure which the backend may use to store stuff. */
@@ -197,9 +198,26 @@ struct InferiorVTable {
 
 	guint32               (* global_wait)         (guint32             *status_ret);
 
+	/*
+	 * Like global_wait(), but only returns an event if one is already
+	 * available and 0 otherwise.
+	 */
+	guint32               (* global_wait_nohang)  (guint32             *status_ret);
+
 	ServerCommandError    (* stop_and_wait)       (ServerHandle        *handle,
 						       guint32             *status);
 
+	/*
+	 * Like stop_and_wait(), but for `count' threads at once: first send all
+	 * of them a stop signal, then wait for all of them.  For each thread,
+	 * `statuses' receives what stop_and_wait() would have returned in
+	 * `status' and `results' its return value.
+	 */
+	ServerCommandError    (* stop_and_wait_group) (ServerHandle       **handles,
+						       guint32              count,
+						       guint32             *statuses,
+						       ServerCommandError  *results);
+
 	ServerStatusMessageType (* dispatch_event)    (ServerHandle        *handle,
 						       guint32              status,
 						       guint64             *arg,
@@ -320,10 +338,19 @@ struct InferiorVTable {
 						       guint64           callback_argument,
 						       gboolean          debug);
 
+	/*
+	 * Execute `instruction' in the code buffer and return to the current
+	 * address; if `update_ip' is set, skip over the original instruction.
+	 *
+	 * If `displacement_offset' is not -1, the instruction has a %rip-relative
+	 * memory operand whose 32-bit displacement is at this offset and which
+	 * needs to be adjusted to the code buffer slot.
+	 */
 	ServerCommandError    (* execute_instruction) (ServerHandle     *handle,
 						       const guint8     *instruction,
 						       guint32           size,
-						       gboolean          update_ip);
+						       gboolean          update_ip,
+						       gint32            displacement_offset);
 
 	ServerCommandError    (* mark_rti_frame)      (ServerHandle     *handle);
 
@@ -444,6 +471,19 @@ struct InferiorVTable {
 	guint32               (*get_current_pid) (void);
 
 	guint64               (*get_current_thread) (void);
+
+	/*
+	 * Read a string of `char_size'-byte characters (1 or 2) which is terminated
+	 * by a zero character, but at most `max_length' characters (0 means no
+	 * limit).  `*data' is a newly allocated buffer containing the string without
+	 * the terminator and `*length' its size in bytes.
+	 */
+	ServerCommandError    (* read_string)          (ServerHandle     *handle,
+							guint64           start,
+							guint32           char_size,
+							guint32           max_length,
+							guint32          *length,
+							gpointer         *data);
 };
 
 /*
@@ -497,6 +537,9 @@ mono_debugger_server_finalize             (ServerHandle       *handle);
 guint32
 mono_debugger_server_global_wait          (guint32                 *status);
 
+guint32
+mono_debugger_server_global_wait_nohang   (guint32                 *status);
+
 ServerStatusMessageType
 mono_debugger_server_dispatch_event       (ServerHandle            *handle,
 					   guint32                  status,
@@ -543,6 +586,14 @@ mono_debugger_server_read_memory          (ServerHandle       *handle,
 					   guint32             size,
 					   gpointer            data);
 
+ServerCommandError
+mono_debugger_server_read_string          (ServerHandle       *handle,
+					   guint64             start,
+					   guint32             char_size,
+					   guint32             max_length,
+					   guint32            *length,
+					   gpointer           *data);
+
 ServerCommandError
 mono_debugger_server_write_memory         (ServerHandle       *handle,
 					   guint64             start,
@@ -597,7 +648,8 @@ ServerCommandError
 mono_debugger_execute_instruction         (ServerHandle        *handle,
 					   const guint8        *instruction,
 					   guint32              instruction_size,
-					   gboolean             update_ip);
+					   gboolean             update_ip,
+					   gint32               displacement_offset);
 
 ServerCommandError
 mono_debugger_mark_rti_framenvoke        (ServerHandle        *handle);
@@ -645,6 +697,12 @@ ServerCommandError
 mono_debugger_server_stop_and_wait       (ServerHandle        *handle,
 					  guint32             *status);
 
+ServerCommandError
+mono_debugger_server_stop_and_wait_group (ServerHandle       **handles,
+					  guint32              count,
+					  guint32             *statuses,
+					  ServerCommandError  *results);
+
 ServerCommandError
 mono_debugger_server_set_signal          (ServerHandle        *handle,
 					  guint32              sig,
@@ -66,6 +66,10 @@ static void
 x86_arch_remove_breakpoints_from_target_memory (ServerHandle *handle, guint64 start,
 						guint32 size, gpointer buffer);
 
+static gpointer
+x86_arch_insert_breakpoints_into_target_memory (ServerHandle *handle, guint64 start,
+						guint32 size, gconstpointer buffer);
+
 static ChildStoppedAction
 x86_arch_child_stopped (ServerHandle *handle, int stopsig,
 			guint64 *callback_arg, guint64 *retval, guint64 *retval2,
@@ -111,8 +111,13 @@ server_ptrace_read_memory (ServerHandle *handle, guint64 start, guint32 size, gp
 	return COMMAND_ERROR_NONE;
 }
 
+/*
+ * Word-by-word write using PT_WRITE_D; only used if we can't write to
+ * /proc/<pid>/mem, for instance to read-only text pages on kernels which
+ * do not allow this.
+ */
 static ServerCommandError
-server_ptrace_write_memory (ServerHandle *handle, guint64 start,
+_server_ptrace_poke_memory (ServerHandle *handle, guint64 start,
 			    guint32 size, gconstpointer buffer)
 {
 	InferiorHandle *inferior = handle->inferior;
@@ -141,7 +146,33 @@ server_ptrace_write_memory (ServerHandle *handle, guint64 start,
 
 	memcpy (&temp, ptr, size);
 
-	return server_ptrace_write_memory (handle, addr, sizeof (long), &temp);
+	return _server_ptrace_poke_memory (handle, addr, sizeof (long), &temp);
+}
+
+static ServerCommandError
+_server_ptrace_write_memory (ServerHandle *handle, guint64 start,
+			     guint32 size, gconstpointer buffer)
+{
+	const guint8 *ptr = buffer;
+	guint64 addr = start;
+
+	while (size) {
+		int ret = pwrite64 (handle->inferior->os.mem_fd, ptr, size, addr);
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+			else if (errno == ESRCH)
+				return COMMAND_ERROR_NOT_STOPPED;
+			return _server_ptrace_poke_memory (handle, addr, size, ptr);
+		} else if (ret == 0)
+			return _server_ptrace_poke_memory (handle, addr, size, ptr);
+
+		size -= ret;
+		ptr += ret;
+		addr += ret;
+	}
+
+	return COMMAND_ERROR_NONE;
 }
 
 static ServerCommandError
@@ -254,6 +285,84 @@ do_wait (int pid, guint32 *status, gboolean nohang)
 static int stop_requested = 0;
 static int stop_status = 0;
 
+/*
+ * While server_ptrace_stop_and_wait_group() is waiting for its threads,
+ * `stop_requested' is -1 and this maps their pids to their index + 1.
+ */
+static GHashTable *stop_group = NULL;
+static int stop_status_pid = 0;
+
+typedef struct {
+	int pid;
+	guint32 status;
+} PendingWaitEvent;
+
+/*
+ * Wait statuses which we already reaped, but didn't report yet: events which
+ * server_ptrace_stop_and_wait_group() received for threads it didn't stop and
+ * the ones drain_wait_events() collected; protected by `wait_mutex'.
+ */
+static GSList *pending_wait_events = NULL;
+
+static void
+add_pending_wait_event (int pid, guint32 status)
+{
+	PendingWaitEvent *event = g_new0 (PendingWaitEvent, 1);
+
+	event->pid = pid;
+	event->status = status;
+
+	pending_wait_events = g_slist_append (pending_wait_events, event);
+}
+
+static gboolean
+take_pending_wait_event (int pid, int *ret_pid, guint32 *status)
+{
+	GSList *l;
+
+	for (l = pending_wait_events; l; l = l->next) {
+		PendingWaitEvent *event = (PendingWaitEvent *) l->data;
+
+		if ((pid > 0) && (event->pid != pid))
+			continue;
+
+		*ret_pid = event->pid;
+		*status = event->status;
+
+		pending_wait_events = g_slist_delete_link (pending_wait_events, l);
+		g_free (event);
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
+/*
+ * Queue all the events which are already available, so the engine can process
+ * them in one go with server_ptrace_global_wait_nohang() instead of waking up
+ * the wait thread for each of them.  Must be called with `wait_mutex' held.
+ */
+static void
+drain_wait_events (void)
+{
+	guint32 status;
+	int ret;
+
+	while ((ret = do_wait (-1, &status, TRUE)) > 0)
+		add_pending_wait_event (ret, status);
+}
+
+static gboolean
+is_stop_requested (int pid)
+{
+	if (stop_requested > 0)
+		return pid == stop_requested;
+	else if (stop_requested < 0)
+		return g_hash_table_lookup (stop_group, GINT_TO_POINTER (pid)) != NULL;
+	else
+		return FALSE;
+}
+
 static guint32
 server_ptrace_global_wait (guint32 *status_ret)
 {
@@ -261,6 +370,9 @@ server_ptrace_global_wait (guint32 *status_ret)
 
  again:
 	g_static_mutex_lock (&wait_mutex);
+	if (take_pending_wait_event (-1, &ret, status_ret))
+		goto out;
+
 	ret = do_wait (-1, &status, FALSE);
 	if (ret <= 0)
 		goto out;
@@ -276,9 +388,10 @@ server_ptrace_global_wait (guint32 *status_ret)
 		   ret, status, stop_requested);
 #endif
 
-	if (ret == stop_requested) {
+	if (is_stop_requested (ret)) {
 		*status_ret = 0;
 		stop_status = status;
+		stop_status_pid = ret;
 		g_static_mutex_unlock (&wait_mutex_2);
 		g_static_mutex_unlock (&wait_mutex);
 
@@ -289,11 +402,31 @@ server_ptrace_global_wait (guint32 *status_ret)
 	g_static_mutex_unlock (&wait_mutex_2);
 
 	*status_ret = status;
+	drain_wait_events ();
  out:
 	g_static_mutex_unlock (&wait_mutex);
 	return ret;
 }
 
+static guint32
+server_ptrace_global_wait_nohang (guint32 *status_ret)
+{
+	guint32 status = 0;
+	int ret;
+
+	/*
+	 * This is called from the engine thread while the wait thread is idle, so
+	 * we can't race against a stop_and_wait() here.
+	 */
+	g_static_mutex_lock (&wait_mutex);
+	if (!take_pending_wait_event (-1, &ret, &status))
+		ret = do_wait (-1, &status, TRUE);
+	g_static_mutex_unlock (&wait_mutex);
+
+	*status_ret = status;
+	return ret;
+}
+
 static gboolean
 _server_ptrace_wait_for_new_thread (ServerHandle *handle)
 {
@@ -320,10 +453,12 @@ _server_ptrace_wait_for_new_thread (ServerHandle *handle)
 
 	/*
 	 * We own the `wait_mutex', so no other thread is currently waiting for the target
-	 * and we can safely wait for it here.
+	 * and we can safely wait for it here - unless server_ptrace_stop_and_wait_group()
+	 * already got its event.
 	 */
 
-	ret = waitpid (handle->inferior->pid, &status, WUNTRACED | __WALL | __WCLONE);
+	if (!take_pending_wait_event (handle->inferior->pid, (int *) &ret, &status))
+		ret = waitpid (handle->inferior->pid, &status, WUNTRACED | __WALL | __WCLONE);
 
 	/*
 	 * Safety check: make sure we got the correct event.
@@ -430,6 +565,12 @@ server_ptrace_stop_and_wait (ServerHandle *handle, guint32 *status)
 
 	stop_requested = stop_status = 0;
 
+	if (take_pending_wait_event (handle->inferior->pid, &ret, status)) {
+		g_static_mutex_unlock (&wait_mutex);
+		g_static_mutex_unlock (&wait_mutex_3);
+		return COMMAND_ERROR_NONE;
+	}
+
 	do {
 #if DEBUG_WAIT
 		g_message (G_STRLOC ": %d - waiting", handle->inferior->pid);
@@ -452,6 +593,127 @@ server_ptrace_stop_and_wait (ServerHandle *handle, guint32 *status)
 	return COMMAND_ERROR_NONE;
 }
 
+static ServerCommandError
+server_ptrace_stop_and_wait_group (ServerHandle **handles, guint32 count,
+				   guint32 *statuses, ServerCommandError *results)
+{
+	GHashTable *group;
+	gboolean *already_stopped;
+	guint32 i, remaining = 0;
+	guint32 status;
+	int ret;
+
+	/*
+	 * Stopping the threads one after another with server_ptrace_stop_and_wait()
+	 * means one full round trip through the scheduler per thread.  Instead, we
+	 * send all of them a SIGSTOP first and then collect all the events with
+	 * one single waitpid() loop.  Any events for other threads which we get
+	 * while doing so are queued and returned by server_ptrace_global_wait().
+	 */
+
+	group = g_hash_table_new (NULL, NULL);
+	already_stopped = g_new0 (gboolean, count);
+
+	g_static_mutex_lock (&wait_mutex_2);
+
+	for (i = 0; i < count; i++) {
+		statuses [i] = 0;
+		results [i] = server_ptrace_stop (handles [i]);
+
+		if (results [i] == COMMAND_ERROR_ALREADY_STOPPED) {
+			results [i] = COMMAND_ERROR_NONE;
+			already_stopped [i] = TRUE;
+		} else if (results [i] == COMMAND_ERROR_NONE) {
+			g_hash_table_insert (group, GINT_TO_POINTER (handles [i]->inferior->pid),
+					     GUINT_TO_POINTER (i + 1));
+			remaining++;
+		}
+	}
+
+#if DEBUG_WAIT
+	g_message (G_STRLOC ": sent SIGSTOP to %d of %d threads", remaining, count);
+#endif
+
+	g_static_mutex_lock (&wait_mutex_3);
+
+	stop_group = group;
+	stop_requested = -1;
+	g_static_mutex_unlock (&wait_mutex_2);
+
+	g_static_mutex_lock (&wait_mutex);
+
+	/*
+	 * The global wait thread may already have got one of our events.
+	 */
+	if (stop_status) {
+		i = GPOINTER_TO_UINT (g_hash_table_lookup (group, GINT_TO_POINTER (stop_status_pid)));
+		g_assert (i > 0);
+
+		statuses [i - 1] = stop_status;
+		g_hash_table_remove (group, GINT_TO_POINTER (stop_status_pid));
+		remaining--;
+	}
+
+	stop_requested = stop_status = stop_status_pid = 0;
+	stop_group = NULL;
+
+	for (i = 0; i < count; i++) {
+		int pid = handles [i]->inferior->pid;
+
+		if (!already_stopped [i]) {
+			/*
+			 * drain_wait_events() may already have queued its event.
+			 */
+			if (g_hash_table_lookup (group, GINT_TO_POINTER (pid)) &&
+			    take_pending_wait_event (pid, &ret, &status)) {
+				statuses [i] = status;
+				g_hash_table_remove (group, GINT_TO_POINTER (pid));
+				remaining--;
+			}
+			continue;
+		}
+
+		if (take_pending_wait_event (pid, &ret, &status))
+			statuses [i] = status;
+		else if (do_wait (pid, &status, TRUE) > 0)
+			statuses [i] = status;
+	}
+
+	while (remaining > 0) {
+		ret = do_wait (-1, &status, FALSE);
+		if (ret == 0)
+			continue;
+		else if (ret < 0)
+			break;
+
+		i = GPOINTER_TO_UINT (g_hash_table_lookup (group, GINT_TO_POINTER (ret)));
+		if (!i) {
+			add_pending_wait_event (ret, status);
+			continue;
+		}
+
+		statuses [i - 1] = status;
+		g_hash_table_remove (group, GINT_TO_POINTER (ret));
+		remaining--;
+	}
+
+	g_static_mutex_unlock (&wait_mutex);
+	g_static_mutex_unlock (&wait_mutex_3);
+
+	/*
+	 * Should never happen.
+	 */
+	for (i = 0; i < count; i++) {
+		if (g_hash_table_lookup (group, GINT_TO_POINTER (handles [i]->inferior->pid)))
+			results [i] = COMMAND_ERROR_NO_TARGET;
+	}
+
+	g_hash_table_destroy (group);
+	g_free (already_stopped);
+
+	return COMMAND_ERROR_NONE;
+}
+
 static ServerCommandError
 _server_ptrace_setup_inferior (ServerHandle *handle)
 {
@@ -459,7 +721,13 @@ _server_ptrace_setup_inferior (ServerHandle *handle)
 
 	x86_arch_remove_hardware_breakpoints (handle);
 
-	handle->inferior->os.mem_fd = open64 (filename, O_RDONLY);
+	/*
+	 * Older kernels don't allow writing to /proc/<pid>/mem; we use ptrace()
+	 * for writing in this case.
+	 */
+	handle->inferior->os.mem_fd = open64 (filename, O_RDWR);
+	if (handle->inferior->os.mem_fd < 0)
+		handle->inferior->os.mem_fd = open64 (filename, O_RDONLY);
 
 	if (handle->inferior->os.mem_fd < 0) {
 		if (errno == EACCES)
@@ -663,6 +931,20 @@ server_ptrace_detach_after_fork (ServerHandle *handle)
 	guint32 status;
 	int ret, i;
 
+	/*
+	 * The wait thread is idle while the engine processes the fork event, so we
+	 * should own `wait_mutex' here.  drain_wait_events() may already have queued
+	 * the child's stop event; take it from there instead of leaving it behind for
+	 * a process we're about to detach from.
+	 */
+	if (!g_static_mutex_trylock (&wait_mutex)) {
+		g_warning (G_STRLOC ": Can't lock mutex: %d", handle->inferior->pid);
+		return COMMAND_ERROR_INTERNAL_ERROR;
+	}
+
+	while (take_pending_wait_event (handle->inferior->pid, &ret, &status))
+		;
+
 	ret = waitpid (handle->inferior->pid, &status, WUNTRACED | WNOHANG | __WALL | __WCLONE);
 	if (ret < 0)
 		g_warning (G_STRLOC ": Can't waitpid for %d: %s", handle->inferior->pid, g_strerror (errno));
@@ -673,6 +955,8 @@ server_ptrace_detach_after_fork (ServerHandle *handle)
 	if (x86_arch_get_registers (handle) != COMMAND_ERROR_NONE)
 		do_wait (handle->inferior->pid, &status, FALSE);
 
+	g_static_mutex_unlock (&wait_mutex);
+
 	result = x86_arch_get_registers (handle);
 	if (result != COMMAND_ERROR_NONE)
 		return result;
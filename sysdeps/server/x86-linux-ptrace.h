@@ -10,4 +10,24 @@ struct OSData
 
 #include "x86-ptrace.h"
 
+/*
+ * PTRACE_SEIZE and PTRACE_INTERRUPT are available since Linux 3.4, but older
+ * C libraries don't define them.
+ */
+#ifndef PTRACE_SEIZE
+#define PTRACE_SEIZE		0x4206
+#endif
+#ifndef PTRACE_INTERRUPT
+#define PTRACE_INTERRUPT	0x4207
+#endif
+#ifndef PTRACE_EVENT_STOP
+#define PTRACE_EVENT_STOP	128
+#endif
+
+#define SEIZE_OPTIONS		(PTRACE_O_TRACECLONE | PTRACE_O_TRACEFORK | \
+				 PTRACE_O_TRACEVFORK | PTRACE_O_TRACEEXEC)
+
+static gboolean
+_server_seize_wait_for_new_thread (ServerHandle *handle);
+
 #endif
@@ -0,0 +1,424 @@
+/*
+ * Alternate Linux backend which attaches with PTRACE_SEIZE instead of
+ * PT_TRACE_ME / PT_ATTACH.
+ *
+ * This allows us to stop a thread with PTRACE_INTERRUPT instead of sending it
+ * a SIGSTOP: the thread reports a PTRACE_EVENT_STOP, which can't be confused
+ * with a real SIGSTOP and which doesn't race against one.  Real stop signals
+ * and job control stops (group-stops) are reported as signals.
+ *
+ * The wait thread doesn't block in waitpid(); it sleeps in epoll_wait() on a
+ * signalfd for SIGCHLD and only holds `wait_mutex' while it reaps the events.
+ * SIGCHLD is blocked in all the debugger's threads (see global_init()), so
+ * it always stays pending for the signalfd.
+ * So stop_and_wait() can simply wait for its thread while holding the mutex and
+ * doesn't need the `stop_requested' handshake with the wait thread.
+ *
+ * Everything else is shared with x86-linux-ptrace.c; this file is included from
+ * x86-ptrace.c and the backend is selected in mono_debugger_server_global_init().
+ */
+
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+
+static int seize_epoll_fd = -1;
+static int seize_signal_fd = -1;
+
+static ServerType
+server_seize_get_server_type (void)
+{
+	return SERVER_TYPE_LINUX_SEIZE;
+}
+
+static void
+server_seize_global_init (void)
+{
+	struct epoll_event event;
+	sigset_t mask;
+
+	server_ptrace_global_init ();
+
+	/*
+	 * We're called by the ThreadManager before it starts the wait and
+	 * engine threads, so they and all the threads they create inherit
+	 * this mask.  The kernel can then only deliver SIGCHLD through the
+	 * signalfd.  child_setup_func() unblocks it again in the debuggee.
+	 */
+	sigemptyset (&mask);
+	sigaddset (&mask, SIGCHLD);
+	pthread_sigmask (SIG_BLOCK, &mask, NULL);
+
+	seize_signal_fd = signalfd (-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+	if (seize_signal_fd < 0) {
+		g_warning (G_STRLOC ": Can't create signalfd: %s", g_strerror (errno));
+		return;
+	}
+
+	seize_epoll_fd = epoll_create1 (EPOLL_CLOEXEC);
+	if (seize_epoll_fd < 0) {
+		g_warning (G_STRLOC ": Can't create epoll fd: %s", g_strerror (errno));
+		return;
+	}
+
+	memset (&event, 0, sizeof (event));
+	event.events = EPOLLIN;
+	event.data.fd = seize_signal_fd;
+
+	if (epoll_ctl (seize_epoll_fd, EPOLL_CTL_ADD, seize_signal_fd, &event))
+		g_warning (G_STRLOC ": Can't add signalfd to epoll: %s", g_strerror (errno));
+}
+
+static guint32
+server_seize_global_wait (guint32 *status_ret)
+{
+	struct signalfd_siginfo info;
+	struct epoll_event event;
+	guint32 status = 0;
+	int ret;
+
+	while (1) {
+		g_static_mutex_lock (&wait_mutex);
+		if (!take_pending_wait_event (-1, &ret, &status)) {
+			ret = do_wait (-1, &status, TRUE);
+			if (ret > 0)
+				drain_wait_events ();
+		}
+		g_static_mutex_unlock (&wait_mutex);
+
+		if (ret != 0)
+			break;
+
+		/*
+		 * If we couldn't create the signalfd, wait for the SIGCHLD itself;
+		 * it's blocked, so it stays pending until we get here.
+		 */
+		if (seize_epoll_fd < 0) {
+			sigset_t mask;
+
+			sigemptyset (&mask);
+			sigaddset (&mask, SIGCHLD);
+			if ((sigwaitinfo (&mask, NULL) < 0) && (errno != EINTR)) {
+				g_warning (G_STRLOC ": sigwaitinfo() failed: %s", g_strerror (errno));
+				return -1;
+			}
+			continue;
+		}
+
+		/*
+		 * epoll_wait() is never restarted after a signal handler, even with
+		 * SA_RESTART; we get EINTR for any signal which is delivered to this
+		 * thread (for instance the runtime's GC suspend signals).  Just look
+		 * for events again; the caller can't tell a spurious wakeup from
+		 * the end of the wait loop.
+		 */
+		ret = epoll_wait (seize_epoll_fd, &event, 1, -1);
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+
+			g_warning (G_STRLOC ": epoll_wait() failed: %s", g_strerror (errno));
+			return -1;
+		}
+
+		/*
+		 * We're only interested in the wakeup; waitpid() tells us which
+		 * children changed their state.
+		 */
+		while (read (seize_signal_fd, &info, sizeof (info)) > 0)
+			;
+	}
+
+#if DEBUG_WAIT
+	g_message (G_STRLOC ": global wait finished: %d - %x", ret, status);
+#endif
+
+	*status_ret = status;
+	return ret;
+}
+
+static ServerCommandError
+server_seize_stop (ServerHandle *handle)
+{
+	ServerCommandError result;
+
+	/*
+	 * Try to get the thread's registers.  If we suceed, then it's already stopped
+	 * and still alive.
+	 */
+	result = x86_arch_get_registers (handle);
+	if (result == COMMAND_ERROR_NONE)
+		return COMMAND_ERROR_ALREADY_STOPPED;
+
+	if (ptrace (PTRACE_INTERRUPT, handle->inferior->pid, NULL, NULL)) {
+		/*
+		 * It's already dead.
+		 */
+		if (errno == ESRCH)
+			return COMMAND_ERROR_NO_TARGET;
+		else
+			return COMMAND_ERROR_UNKNOWN_ERROR;
+	}
+
+	return COMMAND_ERROR_NONE;
+}
+
+static ServerCommandError
+server_seize_stop_and_wait (ServerHandle *handle, guint32 *status)
+{
+	ServerCommandError result;
+	int pid = handle->inferior->pid;
+	int ret;
+
+#if DEBUG_WAIT
+	g_message (G_STRLOC ": stop and wait %d", pid);
+#endif
+
+	g_static_mutex_lock (&wait_mutex);
+
+	result = server_seize_stop (handle);
+	if ((result != COMMAND_ERROR_NONE) && (result != COMMAND_ERROR_ALREADY_STOPPED)) {
+		g_static_mutex_unlock (&wait_mutex);
+		return result;
+	}
+
+	if (take_pending_wait_event (pid, &ret, status)) {
+		g_static_mutex_unlock (&wait_mutex);
+		return COMMAND_ERROR_NONE;
+	}
+
+	if (result == COMMAND_ERROR_ALREADY_STOPPED) {
+		if (do_wait (pid, status, TRUE) <= 0)
+			*status = 0;
+		g_static_mutex_unlock (&wait_mutex);
+		return COMMAND_ERROR_NONE;
+	}
+
+	do {
+		ret = do_wait (pid, status, FALSE);
+	} while (ret == 0);
+	g_static_mutex_unlock (&wait_mutex);
+
+#if DEBUG_WAIT
+	g_message (G_STRLOC ": %d - done waiting %d, %x", pid, ret, *status);
+#endif
+
+	/*
+	 * Should never happen.
+	 */
+	if (ret < 0)
+		return COMMAND_ERROR_NO_TARGET;
+
+	return COMMAND_ERROR_NONE;
+}
+
+static ServerCommandError
+server_seize_stop_and_wait_group (ServerHandle **handles, guint32 count,
+				  guint32 *statuses, ServerCommandError *results)
+{
+	GHashTable *group;
+	guint32 i, remaining = 0;
+	guint32 status;
+	int ret;
+
+	group = g_hash_table_new (NULL, NULL);
+
+	g_static_mutex_lock (&wait_mutex);
+
+	for (i = 0; i < count; i++) {
+		int pid = handles [i]->inferior->pid;
+
+		statuses [i] = 0;
+		results [i] = server_seize_stop (handles [i]);
+
+		if (results [i] == COMMAND_ERROR_ALREADY_STOPPED) {
+			results [i] = COMMAND_ERROR_NONE;
+			if (take_pending_wait_event (pid, &ret, &status))
+				statuses [i] = status;
+			else if (do_wait (pid, &status, TRUE) > 0)
+				statuses [i] = status;
+		} else if (results [i] == COMMAND_ERROR_NONE) {
+			if (take_pending_wait_event (pid, &ret, &status)) {
+				statuses [i] = status;
+				continue;
+			}
+
+			g_hash_table_insert (group, GINT_TO_POINTER (pid), GUINT_TO_POINTER (i + 1));
+			remaining++;
+		}
+	}
+
+	while (remaining > 0) {
+		ret = do_wait (-1, &status, FALSE);
+		if (ret == 0)
+			continue;
+		else if (ret < 0)
+			break;
+
+		i = GPOINTER_TO_UINT (g_hash_table_lookup (group, GINT_TO_POINTER (ret)));
+		if (!i) {
+			add_pending_wait_event (ret, status);
+			continue;
+		}
+
+		statuses [i - 1] = status;
+		g_hash_table_remove (group, GINT_TO_POINTER (ret));
+		remaining--;
+	}
+
+	g_static_mutex_unlock (&wait_mutex);
+
+	/*
+	 * Should never happen.
+	 */
+	for (i = 0; i < count; i++) {
+		if (g_hash_table_lookup (group, GINT_TO_POINTER (handles [i]->inferior->pid)))
+			results [i] = COMMAND_ERROR_NO_TARGET;
+	}
+
+	g_hash_table_destroy (group);
+
+	return COMMAND_ERROR_NONE;
+}
+
+static ServerCommandError
+server_seize_spawn (ServerHandle *handle, const gchar *working_directory,
+		    const gchar **argv, const gchar **envp, gboolean redirect_fds,
+		    gint *child_pid, IOThreadData **io_data, gchar **error)
+{
+	return _server_ptrace_spawn (handle, working_directory, argv, envp, redirect_fds,
+				     child_pid, io_data, error, TRUE);
+}
+
+static gboolean
+_server_seize_wait_for_new_thread (ServerHandle *handle)
+{
+	int pid = handle->inferior->pid;
+	guint32 status = 0;
+	int ret;
+
+	/*
+	 * The wait thread never blocks while holding `wait_mutex', so unlike
+	 * _server_ptrace_wait_for_new_thread() we can just wait for it here.
+	 */
+	g_static_mutex_lock (&wait_mutex);
+	if (!take_pending_wait_event (pid, &ret, &status)) {
+		do {
+			ret = do_wait (pid, &status, FALSE);
+		} while (ret == 0);
+	}
+	g_static_mutex_unlock (&wait_mutex);
+
+	/*
+	 * New threads and PTRACE_INTERRUPT report a PTRACE_EVENT_STOP, a new
+	 * process a PTRACE_EVENT_EXEC; both with SIGTRAP.
+	 */
+	if ((ret != pid) || !WIFSTOPPED (status) || (WSTOPSIG (status) != SIGTRAP)) {
+		g_warning (G_STRLOC ": Wait failed: %d, got pid %d, status %x", pid, ret, status);
+		return FALSE;
+	}
+
+	if (x86_arch_get_registers (handle) != COMMAND_ERROR_NONE) {
+		g_warning (G_STRLOC ": Failed to get registers: %d", pid);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static ServerCommandError
+server_seize_initialize_thread (ServerHandle *handle, guint32 pid, gboolean wait)
+{
+	InferiorHandle *inferior = handle->inferior;
+
+	inferior->is_thread = TRUE;
+	inferior->pid = pid;
+
+	if (wait && !_server_seize_wait_for_new_thread (handle))
+		return COMMAND_ERROR_INTERNAL_ERROR;
+
+	return _server_ptrace_setup_inferior (handle);
+}
+
+static ServerCommandError
+server_seize_attach (ServerHandle *handle, guint32 pid)
+{
+	InferiorHandle *inferior = handle->inferior;
+
+	if (ptrace (PTRACE_SEIZE, pid, NULL, SEIZE_OPTIONS) != 0) {
+		g_warning (G_STRLOC ": Can't attach to %d - %s", pid,
+			   g_strerror (errno));
+		return COMMAND_ERROR_CANNOT_START_TARGET;
+	}
+
+	if (ptrace (PTRACE_INTERRUPT, pid, NULL, NULL) != 0) {
+		g_warning (G_STRLOC ": Can't interrupt %d - %s", pid,
+			   g_strerror (errno));
+		return COMMAND_ERROR_CANNOT_START_TARGET;
+	}
+
+	inferior->pid = pid;
+	inferior->is_thread = TRUE;
+
+	if (!_server_seize_wait_for_new_thread (handle))
+		return COMMAND_ERROR_INTERNAL_ERROR;
+
+	return _server_ptrace_setup_inferior (handle);
+}
+
+static ServerStatusMessageType
+server_seize_dispatch_event (ServerHandle *handle, guint32 status, guint64 *arg,
+			     guint64 *data1, guint64 *data2, guint32 *opt_data_size,
+			     gpointer *opt_data)
+{
+	if ((status >> 16) == PTRACE_EVENT_STOP) {
+		int stopsig = WSTOPSIG (status);
+
+		x86_arch_get_registers (handle);
+		handle->inferior->last_signal = 0;
+
+		/*
+		 * PTRACE_INTERRUPT and the initial stop of a new thread report a
+		 * SIGTRAP, anything else is a group-stop.  The stop signal has
+		 * already been delivered in that case, so we must not send it again
+		 * when resuming the thread.
+		 */
+		if (stopsig == SIGTRAP) {
+			*arg = 0;
+			return MESSAGE_CHILD_INTERRUPTED;
+		}
+
+		*arg = stopsig;
+		return MESSAGE_CHILD_STOPPED;
+	}
+
+	if (WIFSTOPPED (status) && !(status >> 16) && (WSTOPSIG (status) == SIGSTOP)) {
+		/*
+		 * We never send a SIGSTOP, so this is a real one.
+		 */
+		x86_arch_get_registers (handle);
+		handle->inferior->last_signal = SIGSTOP;
+		*arg = SIGSTOP;
+		return MESSAGE_CHILD_STOPPED;
+	}
+
+	return server_ptrace_dispatch_event (
+		handle, status, arg, data1, data2, opt_data_size, opt_data);
+}
+
+static ServerStatusMessageType
+server_seize_dispatch_simple (guint32 status, guint32 *arg)
+{
+	if ((status >> 16) == PTRACE_EVENT_STOP) {
+		int stopsig = WSTOPSIG (status);
+
+		*arg = (stopsig == SIGTRAP) ? 0 : stopsig;
+		return MESSAGE_CHILD_STOPPED;
+	}
+
+	if (WIFSTOPPED (status) && !(status >> 16) && (WSTOPSIG (status) == SIGSTOP)) {
+		*arg = SIGSTOP;
+		return MESSAGE_CHILD_STOPPED;
+	}
+
+	return server_ptrace_dispatch_simple (status, arg);
+}
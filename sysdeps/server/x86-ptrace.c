@@ -330,9 +330,28 @@ server_ptrace_create_inferior (BreakpointManager *bpm)
 }
 
 static void
-child_setup_func (InferiorHandle *inferior)
+child_setup_func (InferiorHandle *inferior, int seize_fd)
 {
-	if (ptrace (PT_TRACE_ME, getpid (), NULL, 0))
+	sigset_t mask;
+
+	/*
+	 * Don't let the debuggee inherit any signals we blocked for ourselves
+	 * (such as SIGCHLD in the PTRACE_SEIZE backend).
+	 */
+	sigemptyset (&mask);
+	sigaddset (&mask, SIGCHLD);
+	sigprocmask (SIG_UNBLOCK, &mask, NULL);
+
+	if (seize_fd >= 0) {
+		char c;
+
+		/*
+		 * Wait until our parent attached to us with PTRACE_SEIZE.
+		 */
+		while ((read (seize_fd, &c, 1) < 0) && (errno == EINTR))
+			;
+		close (seize_fd);
+	} else if (ptrace (PT_TRACE_ME, getpid (), NULL, 0))
 		g_error (G_STRLOC ": Can't PT_TRACEME: %s", g_strerror (errno));
 
 	if (inferior->redirect_fds) {
@@ -341,13 +360,18 @@ child_setup_func (InferiorHandle *inferior)
 	}
 }
 
+/*
+ * If `seize' is set, the child doesn't use PT_TRACE_ME, but waits until we
+ * attached to it with PTRACE_SEIZE; see x86-linux-seize.c.
+ */
 static ServerCommandError
-server_ptrace_spawn (ServerHandle *handle, const gchar *working_directory,
-		     const gchar **argv, const gchar **envp, gboolean redirect_fds,
-		     gint *child_pid, IOThreadData **io_data, gchar **error)
+_server_ptrace_spawn (ServerHandle *handle, const gchar *working_directory,
+		      const gchar **argv, const gchar **envp, gboolean redirect_fds,
+		      gint *child_pid, IOThreadData **io_data, gchar **error,
+		      gboolean seize)
 {	
 	InferiorHandle *inferior = handle->inferior;
-	int fd[2], ret, len, i;
+	int fd[2], seize_fd[2] = { -1, -1 }, ret, len, i;
 	ServerCommandError result;
 
 	*error = NULL;
@@ -365,6 +389,8 @@ server_ptrace_spawn (ServerHandle *handle, const gchar *working_directory,
 	}
 
 	pipe (fd);
+	if (seize)
+		pipe (seize_fd);
 
 	*child_pid = fork ();
 	if (*child_pid == 0) {
@@ -382,7 +408,10 @@ server_ptrace_spawn (ServerHandle *handle, const gchar *working_directory,
 		core_limit.rlim_cur = 0;
 		setrlimit (RLIMIT_CORE, &core_limit);
 
-		child_setup_func (inferior);
+		if (seize)
+			close (seize_fd [1]);
+
+		child_setup_func (inferior, seize_fd [0]);
 		execve (argv [0], (char **) argv, (char **) envp);
 
 		error_message = g_strdup_printf ("Cannot exec `%s': %s", argv [0], g_strerror (errno));
@@ -399,6 +428,10 @@ server_ptrace_spawn (ServerHandle *handle, const gchar *working_directory,
 		}
 		close (fd [0]);
 		close (fd [1]);
+		if (seize) {
+			close (seize_fd [0]);
+			close (seize_fd [1]);
+		}
 
 		*error = g_strdup_printf ("fork() failed: %s", g_strerror (errno));
 		return COMMAND_ERROR_CANNOT_START_TARGET;
@@ -410,6 +443,34 @@ server_ptrace_spawn (ServerHandle *handle, const gchar *working_directory,
 	}
 	close (fd [1]);
 
+#ifdef PTRACE_SEIZE
+	if (seize) {
+		int seize_errno = 0;
+
+		close (seize_fd [0]);
+
+		if (ptrace (PTRACE_SEIZE, *child_pid, NULL, SEIZE_OPTIONS))
+			seize_errno = errno;
+
+		if (seize_errno)
+			kill (*child_pid, SIGKILL);
+		write (seize_fd [1], "", 1);
+		close (seize_fd [1]);
+
+		if (seize_errno) {
+			waitpid (*child_pid, NULL, 0);
+			close (fd [0]);
+			if (redirect_fds) {
+				close (inferior->output_fd[0]);
+				close (inferior->error_fd[0]);
+			}
+
+			*error = g_strdup_printf ("PTRACE_SEIZE failed: %s", g_strerror (seize_errno));
+			return COMMAND_ERROR_CANNOT_START_TARGET;
+		}
+	}
+#endif
+
 	ret = read (fd [0], &len, sizeof (len));
 
 	if (ret != 0) {
@@ -429,7 +490,18 @@ server_ptrace_spawn (ServerHandle *handle, const gchar *working_directory,
 
 	inferior->pid = *child_pid;
 
-#ifndef __MACH__
+#ifdef PTRACE_SEIZE
+	/*
+	 * The PTRACE_SEIZE wait thread polls waitpid() instead of blocking in
+	 * it while holding `wait_mutex', so we must use its helper: it also
+	 * looks at the events which the wait thread already queued and only
+	 * accepts the SIGTRAP which a seized child reports.
+	 */
+	if (seize && !_server_seize_wait_for_new_thread (handle))
+		return COMMAND_ERROR_INTERNAL_ERROR;
+	else if (!seize && !_server_ptrace_wait_for_new_thread (handle))
+		return COMMAND_ERROR_INTERNAL_ERROR;
+#elif !defined(__MACH__)
 	if (!_server_ptrace_wait_for_new_thread (handle))
 		return COMMAND_ERROR_INTERNAL_ERROR;
 #endif
@@ -450,6 +522,15 @@ server_ptrace_spawn (ServerHandle *handle, const gchar *working_directory,
 	return COMMAND_ERROR_NONE;
 }
 
+static ServerCommandError
+server_ptrace_spawn (ServerHandle *handle, const gchar *working_directory,
+		     const gchar **argv, const gchar **envp, gboolean redirect_fds,
+		     gint *child_pid, IOThreadData **io_data, gchar **error)
+{
+	return _server_ptrace_spawn (handle, working_directory, argv, envp, redirect_fds,
+				     child_pid, io_data, error, FALSE);
+}
+
 static ServerCommandError
 server_ptrace_initialize_thread (ServerHandle *handle, guint32 pid, gboolean wait)
 {
@@ -574,11 +655,83 @@ server_ptrace_get_current_thread (void)
 	return pthread_self ();
 }
 
+/*
+ * If the write overlaps any inserted breakpoints, the new contents become their
+ * saved instructions and we keep the breakpoint instructions in the target.
+ */
+static ServerCommandError
+server_ptrace_write_memory (ServerHandle *handle, guint64 start,
+			    guint32 size, gconstpointer buffer)
+{
+	ServerCommandError result;
+	gpointer copy;
+
+	copy = x86_arch_insert_breakpoints_into_target_memory (handle, start, size, buffer);
+	result = _server_ptrace_write_memory (handle, start, size, copy ? copy : buffer);
+	g_free (copy);
+
+	return result;
+}
+
+#define READ_STRING_CHUNK_SIZE	4096
+
+/*
+ * Read the string in chunks which never cross a page boundary, so we don't
+ * fault on an unmapped page after the terminator.
+ */
+static ServerCommandError
+server_ptrace_read_string (ServerHandle *handle, guint64 start, guint32 char_size,
+			   guint32 max_length, guint32 *length, gpointer *data)
+{
+	guint8 chunk [READ_STRING_CHUNK_SIZE];
+	GByteArray *array;
+	guint64 address = start;
+	guint64 max_size = (guint64) max_length * char_size;
+
+	if ((char_size != 1) && (char_size != 2))
+		return COMMAND_ERROR_INTERNAL_ERROR;
+
+	array = g_byte_array_new ();
+
+	while (!max_length || (array->len < max_size)) {
+		ServerCommandError result;
+		guint32 size, i;
+
+		size = READ_STRING_CHUNK_SIZE - (address & (READ_STRING_CHUNK_SIZE - 1));
+		if (max_length && (array->len + size > max_size))
+			size = max_size - array->len;
+		if (size < char_size)
+			size = char_size;
+
+		result = server_ptrace_read_memory (handle, address, size, chunk);
+		if (result != COMMAND_ERROR_NONE) {
+			g_byte_array_free (array, TRUE);
+			return result;
+		}
+
+		for (i = 0; i + char_size <= size; i += char_size) {
+			if (!chunk [i] && ((char_size == 1) || !chunk [i+1])) {
+				g_byte_array_append (array, chunk, i);
+				goto out;
+			}
+		}
+
+		g_byte_array_append (array, chunk, i);
+		address += i;
+	}
+
+ out:
+	*length = array->len;
+	*data = g_byte_array_free (array, FALSE);
+	return COMMAND_ERROR_NONE;
+}
+
 extern void GC_start_blocking (void);
 extern void GC_end_blocking (void);
 
 #ifdef __linux__
 #include "x86-linux-ptrace.c"
+#include "x86-linux-seize.c"
 #endif
 
 #ifdef __FreeBSD__
@@ -611,7 +764,9 @@ InferiorVTable i386_ptrace_inferior = {
 	server_ptrace_detach,
 	server_ptrace_finalize,
 	server_ptrace_global_wait,
+	server_ptrace_global_wait_nohang,
 	server_ptrace_stop_and_wait,
+	server_ptrace_stop_and_wait_group,
 	server_ptrace_dispatch_event,
 	server_ptrace_dispatch_simple,
 	server_ptrace_get_target_info,
@@ -653,5 +808,70 @@ InferiorVTable i386_ptrace_inferior = {
 	server_ptrace_restart_notification,
 	server_ptrace_get_registers_from_core_file,
 	server_ptrace_get_current_pid,
-	server_ptrace_get_current_thread
+	server_ptrace_get_current_thread,
+	server_ptrace_read_string
 };
+
+#ifdef __linux__
+InferiorVTable x86_linux_seize_inferior = {
+	server_seize_global_init,
+	server_seize_get_server_type,
+	server_ptrace_get_capabilities,
+	server_ptrace_create_inferior,
+	server_ptrace_initialize_process,
+	server_seize_initialize_thread,
+	server_ptrace_set_runtime_info,
+	server_ptrace_io_thread_main,
+	server_seize_spawn,
+	server_seize_attach,
+	server_ptrace_detach,
+	server_ptrace_finalize,
+	server_seize_global_wait,
+	server_ptrace_global_wait_nohang,
+	server_seize_stop_and_wait,
+	server_seize_stop_and_wait_group,
+	server_seize_dispatch_event,
+	server_seize_dispatch_simple,
+	server_ptrace_get_target_info,
+	server_ptrace_continue,
+	server_ptrace_step,
+	server_ptrace_resume,
+	server_ptrace_get_frame,
+	server_ptrace_current_insn_is_bpt,
+	server_ptrace_peek_word,
+	server_ptrace_read_memory,
+	server_ptrace_write_memory,
+	server_ptrace_call_method,
+	server_ptrace_call_method_1,
+	server_ptrace_call_method_2,
+	server_ptrace_call_method_3,
+	server_ptrace_call_method_invoke,
+	server_ptrace_execute_instruction,
+	server_ptrace_mark_rti_frame,
+	server_ptrace_abort_invoke,
+	server_ptrace_insert_breakpoint,
+	server_ptrace_insert_hw_breakpoint,
+	server_ptrace_remove_breakpoint,
+	server_ptrace_enable_breakpoint,
+	server_ptrace_disable_breakpoint,
+	server_ptrace_get_breakpoints,
+	server_ptrace_get_registers,
+	server_ptrace_set_registers,
+	server_seize_stop,
+	server_ptrace_set_signal,
+	server_ptrace_get_pending_signal,
+	server_ptrace_kill,
+	server_ptrace_get_signal_info,
+	server_ptrace_get_threads,
+	server_ptrace_get_application,
+	server_ptrace_detach_after_fork,
+	server_ptrace_push_registers,
+	server_ptrace_pop_registers,
+	server_ptrace_get_callback_frame,
+	server_ptrace_restart_notification,
+	server_ptrace_get_registers_from_core_file,
+	server_ptrace_get_current_pid,
+	server_ptrace_get_current_thread,
+	server_ptrace_read_string
+};
+#endif
@@ -68,6 +68,10 @@ _server_ptrace_read_memory (ServerHandle *handle, guint64 start,
 static ServerCommandError
 server_ptrace_read_memory (ServerHandle *handle, guint64 start, guint32 size, gpointer buffer);
 
+static ServerCommandError
+_server_ptrace_write_memory (ServerHandle *handle, guint64 start,
+			     guint32 size, gconstpointer buffer);
+
 static ServerCommandError
 server_ptrace_write_memory (ServerHandle *handle, guint64 start,
 			    guint32 size, gconstpointer buffer);
@@ -90,12 +94,19 @@ server_ptrace_step (ServerHandle *handle);
 static ServerCommandError
 server_ptrace_kill (ServerHandle *handle);
 
+static guint32
+server_ptrace_global_wait_nohang (guint32 *status_ret);
+
 static ServerCommandError
 server_ptrace_stop (ServerHandle *handle);
 
 static ServerCommandError
 server_ptrace_stop_and_wait (ServerHandle *handle, guint32 *status);
 
+static ServerCommandError
+server_ptrace_stop_and_wait_group (ServerHandle **handles, guint32 count,
+				   guint32 *statuses, ServerCommandError *results);
+
 static ServerCommandError
 _server_ptrace_setup_inferior (ServerHandle *handle);
 
@@ -2390,7 +2390,9 @@ InferiorVTable i386_windows_inferior = {
 	NULL,					 			/*detach, */
 	NULL,					 			/*finalize, */
 	server_win32_global_wait,			/*global_wait, */
+	NULL,					 			/*global_wait_nohang, */
 	NULL,					 			/*stop_and_wait, */
+	NULL,					 			/*stop_and_wait_group, */
 	server_win32_dispatch_event,		/*dispatch_event, */
 	server_win32_dispatch_simple,								/*dispatch_simple, */
 	server_win32_get_target_info,		/*get_target_info, */
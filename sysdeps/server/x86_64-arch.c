@@ -90,27 +90,68 @@ void
 x86_arch_remove_breakpoints_from_target_memory (ServerHandle *handle, guint64 start,
 						guint32 size, gpointer buffer)
 {
-	GPtrArray *breakpoints;
+	const BreakpointIndex *index;
 	guint8 *ptr = buffer;
-	int i;
+	guint32 i;
+
+	/*
+	 * This is called for every single memory read, so we use the address
+	 * index here and don't take the breakpoint manager lock.
+	 */
+	index = mono_debugger_breakpoint_manager_begin_read (handle->bpm);
+	for (i = mono_debugger_breakpoint_index_lower_bound (index, start); i < index->count; i++) {
+		BreakpointInfo *info = index->entries [i];
+		guint64 offset;
+
+		if (info->address >= start+size)
+			break;
+		if (info->is_hardware_bpt || !g_atomic_int_get (&info->enabled))
+			continue;
+
+		offset = (guint64) info->address - start;
+		ptr [offset] = info->saved_insn;
+	}
+	mono_debugger_breakpoint_manager_end_read (handle->bpm);
+}
+
+gpointer
+x86_arch_insert_breakpoints_into_target_memory (ServerHandle *handle, guint64 start,
+						guint32 size, gconstpointer buffer)
+{
+	const BreakpointIndex *index;
+	guint8 *copy = NULL;
+	guint32 i;
 
 	mono_debugger_breakpoint_manager_lock ();
 
-	breakpoints = mono_debugger_breakpoint_manager_get_breakpoints (handle->bpm);
-	for (i = 0; i < breakpoints->len; i++) {
-		BreakpointInfo *info = g_ptr_array_index (breakpoints, i);
+	index = mono_debugger_breakpoint_manager_begin_read (handle->bpm);
+	for (i = mono_debugger_breakpoint_index_lower_bound (index, start); i < index->count; i++) {
+		BreakpointInfo *info = index->entries [i];
 		guint64 offset;
 
+		if (info->address >= start+size)
+			break;
 		if (info->is_hardware_bpt || !info->enabled)
 			continue;
-		if ((info->address < start) || (info->address >= start+size))
-			continue;
+
+		if (!copy)
+			copy = g_memdup (buffer, size);
 
 		offset = (guint64) info->address - start;
-		ptr [offset] = info->saved_insn;
+		info->saved_insn = copy [offset];
+		copy [offset] = 0xcc;
+
+		if (handle->mono_runtime) {
+			guint64 table_address = handle->mono_runtime->breakpoint_info_area +
+				16 * info->runtime_table_slot;
+
+			server_ptrace_poke_word (handle, table_address + 8, (gsize) info->saved_insn);
+		}
 	}
+	mono_debugger_breakpoint_manager_end_read (handle->bpm);
 
 	mono_debugger_breakpoint_manager_unlock ();
+	return copy;
 }
 
 static ServerCommandError
@@ -661,9 +702,17 @@ x86_arch_enable_breakpoint (ServerHandle *handle, BreakpointInfo *breakpoint)
 				return result;
 		}
 
-		result = server_ptrace_write_memory (handle, address, 1, &bopcode);
-		if (result != COMMAND_ERROR_NONE)
+		/*
+		 * Readers must see the breakpoint as enabled before the breakpoint
+		 * instruction is in memory; see the comment in breakpoints.c.
+		 */
+		g_atomic_int_set (&breakpoint->enabled, TRUE);
+
+		result = _server_ptrace_write_memory (handle, address, 1, &bopcode);
+		if (result != COMMAND_ERROR_NONE) {
+			g_atomic_int_set (&breakpoint->enabled, FALSE);
 			return result;
+		}
 	}
 
 	return COMMAND_ERROR_NONE;
@@ -699,7 +748,7 @@ x86_arch_disable_breakpoint (ServerHandle *handle, BreakpointInfo *breakpoint)
 
 		arch->dr_regs [breakpoint->dr_index] = 0;
 	} else {
-		result = server_ptrace_write_memory (handle, address, 1, &breakpoint->saved_insn);
+		result = _server_ptrace_write_memory (handle, address, 1, &breakpoint->saved_insn);
 		if (result != COMMAND_ERROR_NONE)
 			return result;
 
@@ -734,15 +783,21 @@ server_ptrace_insert_breakpoint (ServerHandle *handle, guint64 address, guint32
 	breakpoint->id = mono_debugger_breakpoint_manager_get_next_id ();
 	breakpoint->dr_index = -1;
 
+	/*
+	 * Add it to the address index before writing the breakpoint instruction, so the
+	 * lock-free readers know about it as soon as it's in memory.
+	 */
+	mono_debugger_breakpoint_manager_insert (handle->bpm, (BreakpointInfo *) breakpoint);
+
 	result = x86_arch_enable_breakpoint (handle, breakpoint);
 	if (result != COMMAND_ERROR_NONE) {
+		/* This also frees it once there are no more readers. */
+		mono_debugger_breakpoint_manager_remove (handle->bpm, breakpoint);
 		mono_debugger_breakpoint_manager_unlock ();
-		g_free (breakpoint);
 		return result;
 	}
 
-	breakpoint->enabled = TRUE;
-	mono_debugger_breakpoint_manager_insert (handle->bpm, (BreakpointInfo *) breakpoint);
+	g_atomic_int_set (&breakpoint->enabled, TRUE);
  done:
 	*bhandle = breakpoint->id;
 	mono_debugger_breakpoint_manager_unlock ();
@@ -773,7 +828,7 @@ server_ptrace_remove_breakpoint (ServerHandle *handle, guint32 idx)
 	if (result != COMMAND_ERROR_NONE)
 		goto out;
 
-	breakpoint->enabled = FALSE;
+	g_atomic_int_set (&breakpoint->enabled, FALSE);
 	mono_debugger_breakpoint_manager_remove (bpm, breakpoint);
 
  out:
@@ -850,7 +905,7 @@ server_ptrace_enable_breakpoint (ServerHandle *handle, guint32 idx)
 	}
 
 	result = x86_arch_enable_breakpoint (handle, breakpoint);
-	breakpoint->enabled = TRUE;
+	g_atomic_int_set (&breakpoint->enabled, TRUE);
 	mono_debugger_breakpoint_manager_unlock ();
 	return result;
 }
@@ -869,7 +924,7 @@ server_ptrace_disable_breakpoint (ServerHandle *handle, guint32 idx)
 	}
 
 	result = x86_arch_disable_breakpoint (handle, breakpoint);
-	breakpoint->enabled = FALSE;
+	g_atomic_int_set (&breakpoint->enabled, FALSE);
 	mono_debugger_breakpoint_manager_unlock ();
 	return result;
 }
@@ -1257,12 +1312,13 @@ find_code_buffer_slot (MonoRuntimeInfo *runtime)
 
 static ServerCommandError
 server_ptrace_execute_instruction (ServerHandle *handle, const guint8 *instruction,
-				   guint32 size, gboolean update_ip)
+				   guint32 size, gboolean update_ip, gint32 displacement_offset)
 {
 	MonoRuntimeInfo *runtime;
 	ServerCommandError result;
 	CodeBufferData *data;
-	guint64 code_address;
+	guint64 code_address, original_rip;
+	guint8 *code;
 	int slot;
 
 	runtime = handle->mono_runtime;
@@ -1281,17 +1337,48 @@ server_ptrace_execute_instruction (ServerHandle *handle, const guint8 *instructi
 		return COMMAND_ERROR_INTERNAL_ERROR;
 
 	code_address = runtime->executable_code_buffer + slot * runtime->executable_code_chunk_size;
+	original_rip = INFERIOR_REG_RIP (handle->arch->current_regs);
+
+	code = g_memdup (instruction, size);
+
+	/*
+	 * The instruction addresses memory relative to %rip, so adjust its
+	 * displacement to make it access the same memory from the code buffer.
+	 */
+	if (displacement_offset >= 0) {
+		gint32 displacement;
+		gint64 new_displacement;
+
+		if (displacement_offset + sizeof (gint32) > size) {
+			runtime->executable_code_bitfield [slot] = 0;
+			g_free (code);
+			return COMMAND_ERROR_INTERNAL_ERROR;
+		}
+
+		memcpy (&displacement, code + displacement_offset, sizeof (gint32));
+		new_displacement = (gint64) displacement + (gint64) (original_rip - code_address);
+
+		if ((new_displacement < G_MININT32) || (new_displacement > G_MAXINT32)) {
+			runtime->executable_code_bitfield [slot] = 0;
+			g_free (code);
+			return COMMAND_ERROR_INTERNAL_ERROR;
+		}
+
+		displacement = (gint32) new_displacement;
+		memcpy (code + displacement_offset, &displacement, sizeof (gint32));
+	}
 
 	data = g_new0 (CodeBufferData, 1);
 	data->slot = slot;
 	data->insn_size = size;
 	data->update_ip = update_ip;
-	data->original_rip = INFERIOR_REG_RIP (handle->arch->current_regs);
+	data->original_rip = original_rip;
 	data->code_address = code_address;
 
 	handle->arch->code_buffer = data;
 
-	result = server_ptrace_write_memory (handle, code_address, size, instruction);
+	result = server_ptrace_write_memory (handle, code_address, size, code);
+	g_free (code);
 	if (result != COMMAND_ERROR_NONE)
 		return result;
 
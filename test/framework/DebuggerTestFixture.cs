@@ -1024,6 +1024,20 @@ namespace Mono.Debugger.Test.Framework
 			return process;
 		}
 
+		public Process ReloadSession (Process process)
+		{
+			byte[] session;
+			using (MemoryStream ms = new MemoryStream ()) {
+				Interpreter.SaveSession (ms);
+				session = ms.GetBuffer ();
+			}
+			AssertExecute ("kill");
+			AssertTargetExited (process);
+
+			using (MemoryStream ms = new MemoryStream (session))
+				return LoadSession (ms);
+		}
+
 		public Process Attach (int pid)
 		{
 			Process process = Interpreter.Attach (pid);
@@ -0,0 +1,17 @@
+using System;
+
+class X
+{
+	static int Add (int a, int b)
+	{
+		return a + b;
+	}
+
+	static void Main ()
+	{
+		int sum = 0;
+		for (int i = 0; i < 10; i++)
+			sum = Add (sum, i);
+		Console.WriteLine (sum);
+	}
+}
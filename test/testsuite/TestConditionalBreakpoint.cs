@@ -0,0 +1,76 @@
+using System;
+using NUnit.Framework;
+
+using Mono.Debugger;
+using Mono.Debugger.Languages;
+using Mono.Debugger.Frontend;
+using Mono.Debugger.Test.Framework;
+
+namespace Mono.Debugger.Tests
+{
+	[DebuggerTestFixture]
+	public class TestConditionalBreakpoint : DebuggerTestFixture
+	{
+		public TestConditionalBreakpoint ()
+			: base ("TestConditionalBreakpoint")
+		{ }
+
+		const int line_add = 7;
+		const int line_main = 12;
+
+		[Test]
+		[Category("ManagedTypes")]
+		public void Main ()
+		{
+			Process process = Start ();
+			Assert.IsTrue (process.IsManaged);
+			Assert.IsTrue (process.MainThread.IsStopped);
+			Thread thread = process.MainThread;
+
+			AssertStopped (thread, "X.Main()", line_main);
+
+			int bpt_add = AssertBreakpoint (line_add);
+			Breakpoint bpt = (Breakpoint) Interpreter.GetEvent (bpt_add);
+
+			// The condition doesn't hold for the first three calls.
+			AssertExecute ("condition " + bpt_add + " b == 3");
+			AssertExecute ("continue");
+			AssertHitBreakpoint (thread, bpt_add, "X.Add(int,int)", line_add);
+			AssertPrint (thread, "b", "(int) 3");
+			Assert.AreEqual (1, bpt.HitCount);
+
+			AssertExecute ("condition " + bpt_add);
+			Assert.IsNull (bpt.Condition);
+
+			// Ignored hits are counted, but don't stop.
+			AssertExecute ("ignore " + bpt_add + " 2");
+			AssertExecute ("continue");
+			AssertHitBreakpoint (thread, bpt_add, "X.Add(int,int)", line_add);
+			AssertPrint (thread, "b", "(int) 6");
+			Assert.AreEqual (4, bpt.HitCount);
+			Assert.AreEqual (0, bpt.IgnoreCount);
+
+			AssertExecute ("condition " + bpt_add + " b == 8");
+			AssertExecute ("ignore " + bpt_add + " 1");
+
+			process = ReloadSession (process);
+			Assert.IsTrue (process.IsManaged);
+			Assert.IsTrue (process.MainThread.IsStopped);
+			thread = process.MainThread;
+
+			AssertStopped (thread, "X.Main()", line_main);
+
+			bpt = (Breakpoint) Interpreter.GetEvent (bpt_add);
+			Assert.IsNotNull (bpt.Condition);
+			Assert.AreEqual ("b == 8", bpt.Condition.Text);
+			Assert.AreEqual (1, bpt.IgnoreCount);
+			Assert.AreEqual (4, bpt.HitCount);
+
+			// The only hit where the condition holds is ignored.
+			AssertExecute ("continue");
+			AssertTargetOutput ("45");
+			AssertTargetExited (thread.Process);
+			Assert.AreEqual (5, bpt.HitCount);
+		}
+	}
+}
@@ -0,0 +1,90 @@
+using System;
+using NUnit.Framework;
+
+using Mono.Debugger;
+using Mono.Debugger.Languages;
+using Mono.Debugger.Frontend;
+using Mono.Debugger.Test.Framework;
+
+namespace Mono.Debugger.Tests
+{
+	[DebuggerTestFixture]
+	public class TestTracepoint : DebuggerTestFixture
+	{
+		public TestTracepoint ()
+			: base ("TestConditionalBreakpoint")
+		{ }
+
+		const int line_add = 7;
+		const int line_main = 12;
+		const int line_main_2 = 15;
+
+		[Test]
+		[Category("ManagedTypes")]
+		public void Main ()
+		{
+			Process process = Start ();
+			Assert.IsTrue (process.IsManaged);
+			Assert.IsTrue (process.MainThread.IsStopped);
+			Thread thread = process.MainThread;
+
+			AssertStopped (thread, "X.Main()", line_main);
+
+			object result = AssertExecute (String.Format ("trace {0}:{1}", FileName, line_add));
+			Assert.IsNotNull (result);
+			int tp_add = (int) result;
+
+			Breakpoint tp = (Breakpoint) Interpreter.GetEvent (tp_add);
+			Assert.IsTrue (tp.IsTracepoint);
+
+			AssertExecute ("actions " + tp_add + " a; b");
+			int bpt_main_2 = AssertBreakpoint (line_main_2);
+
+			// The tracepoint collects its frames without stopping.
+			AssertExecute ("continue");
+			AssertHitBreakpoint (thread, bpt_main_2, "X.Main()", line_main_2);
+			Assert.AreEqual (10, tp.HitCount);
+			AssertTraceFrames (process, tp_add);
+
+			process = ReloadSession (process);
+			Assert.IsTrue (process.IsManaged);
+			Assert.IsTrue (process.MainThread.IsStopped);
+			thread = process.MainThread;
+
+			AssertStopped (thread, "X.Main()", line_main);
+
+			tp = (Breakpoint) Interpreter.GetEvent (tp_add);
+			Assert.IsTrue (tp.IsTracepoint);
+			Assert.AreEqual (2, tp.TraceActions.Length);
+			Assert.AreEqual (TraceActionType.Expression, tp.TraceActions [0].Type);
+			Assert.AreEqual ("a", tp.TraceActions [0].Expression.Text);
+			Assert.AreEqual (TraceActionType.Expression, tp.TraceActions [1].Type);
+			Assert.AreEqual ("b", tp.TraceActions [1].Expression.Text);
+
+			AssertExecute ("continue");
+			AssertHitBreakpoint (thread, bpt_main_2, "X.Main()", line_main_2);
+			AssertTraceFrames (process, tp_add);
+
+			AssertExecute ("continue");
+			AssertTargetOutput ("45");
+			AssertTargetExited (thread.Process);
+		}
+
+		void AssertTraceFrames (Process process, int tracepoint)
+		{
+			TraceFrame[] frames = process.TraceBuffer.GetFrames ();
+			Assert.AreEqual (10, frames.Length);
+
+			int sum = 0;
+			for (int i = 0; i < frames.Length; i++) {
+				Assert.AreEqual (tracepoint, frames [i].Tracepoint);
+				Assert.AreEqual (2, frames [i].Values.Length);
+				Assert.AreEqual ("a", frames [i].Values [0].Key);
+				Assert.AreEqual ("(int) " + sum, frames [i].Values [0].Value);
+				Assert.AreEqual ("b", frames [i].Values [1].Key);
+				Assert.AreEqual ("(int) " + i, frames [i].Values [1].Value);
+				sum += i;
+			}
+		}
+	}
+}